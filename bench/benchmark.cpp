@@ -0,0 +1,120 @@
+#include "benchmark.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+BenchmarkResult measure(const std::string &name, size_t entities, const BenchmarkBody &body, double minSeconds) {
+    using clock = std::chrono::steady_clock;
+
+    // one untimed call warms caches and lets lazily grown buffers reach their steady size
+    body();
+
+    size_t iterations = 1;
+    double seconds = 0;
+    while (true) {
+        clock::time_point start = clock::now();
+        for (size_t i = 0; i < iterations; i++)
+            body();
+        seconds = std::chrono::duration<double>(clock::now() - start).count();
+        if (seconds >= minSeconds)
+            break;
+        iterations *= 2;
+    }
+
+    double nsPerOp = seconds * 1e9 / iterations;
+    return {name, entities, iterations, nsPerOp, entities > 0 ? nsPerOp / entities : nsPerOp};
+}
+
+bool writeJson(const std::string &path, const std::vector<BenchmarkResult> &results) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cout << "ERROR::BENCHMARK: Failed to write " << path << std::endl;
+        return false;
+    }
+    file << "[\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult &result = results[i];
+        file << "  {\"name\": \"" << result.name << "\", \"entities\": " << result.entities
+             << ", \"iterations\": " << result.iterations << ", \"ns_per_op\": " << result.nsPerOp
+             << ", \"ns_per_entity\": " << result.nsPerEntity << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "]\n";
+    return true;
+}
+
+bool writeCsv(const std::string &path, const std::vector<BenchmarkResult> &results) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cout << "ERROR::BENCHMARK: Failed to write " << path << std::endl;
+        return false;
+    }
+    file << "name,entities,iterations,ns_per_op,ns_per_entity\n";
+    for (const BenchmarkResult &result : results)
+        file << result.name << "," << result.entities << "," << result.iterations << ","
+             << result.nsPerOp << "," << result.nsPerEntity << "\n";
+    return true;
+}
+
+bool readCsv(const std::string &path, std::vector<BenchmarkResult> &results) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cout << "ERROR::BENCHMARK: Failed to read " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    std::getline(file, line); // header
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::stringstream stream(line);
+        BenchmarkResult result;
+        std::string field;
+        std::getline(stream, result.name, ',');
+        // stoul/stod throw on empty or non-numeric fields, e.g. from a hand-edited or truncated file
+        try {
+            std::getline(stream, field, ',');
+            result.entities = std::stoul(field);
+            std::getline(stream, field, ',');
+            result.iterations = std::stoul(field);
+            std::getline(stream, field, ',');
+            result.nsPerOp = std::stod(field);
+            std::getline(stream, field, ',');
+            result.nsPerEntity = std::stod(field);
+        } catch (const std::exception &) {
+            std::cout << "ERROR::BENCHMARK: malformed row in " << path << ": " << line << std::endl;
+            return false;
+        }
+        results.push_back(result);
+    }
+    return true;
+}
+
+int compareToBaseline(const std::vector<BenchmarkResult> &results, const std::vector<BenchmarkResult> &baseline,
+                      double tolerance) {
+    int regressions = 0;
+    std::printf("\n%-16s %10s %14s %14s %8s\n", "benchmark", "entities", "baseline ns", "current ns", "ratio");
+    for (const BenchmarkResult &result : results) {
+        const BenchmarkResult *previous = nullptr;
+        for (const BenchmarkResult &entry : baseline) {
+            if (entry.name == result.name && entry.entities == result.entities) {
+                previous = &entry;
+                break;
+            }
+        }
+        if (previous == nullptr) {
+            std::printf("%-16s %10zu %14s %14.1f %8s\n", result.name.c_str(), result.entities, "-", result.nsPerOp, "new");
+            continue;
+        }
+        double ratio = result.nsPerOp / previous->nsPerOp;
+        bool regressed = ratio > 1.0 + tolerance;
+        if (regressed)
+            regressions++;
+        std::printf("%-16s %10zu %14.1f %14.1f %7.2fx%s\n", result.name.c_str(), result.entities,
+                    previous->nsPerOp, result.nsPerOp, ratio, regressed ? "  REGRESSION" : "");
+    }
+    return regressions;
+}
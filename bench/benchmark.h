@@ -0,0 +1,90 @@
+#ifndef GRAPHICS_BENCHMARK_H
+#define GRAPHICS_BENCHMARK_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Timing of one benchmark at one entity count
+ */
+struct BenchmarkResult {
+    std::string name;
+    size_t entities;
+    size_t iterations;
+    double nsPerOp;
+    double nsPerEntity;
+};
+
+/**
+ * @brief The timed part of a benchmark, called repeatedly
+ */
+using BenchmarkBody = std::function<void()>;
+
+/**
+ * @brief A benchmark case
+ * @details setup builds the state for an entity count and returns the body to time;
+ * it runs once per entity count and is not timed.
+ */
+struct BenchmarkCase {
+    std::string name;
+    std::function<BenchmarkBody(size_t entities)> setup;
+};
+
+/**
+ * @brief Keeps the compiler from optimizing away a value that is never read
+ */
+template<typename T>
+inline void doNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * @brief Times a benchmark body
+ * @details The iteration count doubles until a batch runs for at least minSeconds,
+ * so cheap and expensive bodies are both measured over a similar wall time.
+ *
+ * @param name Benchmark name for the result
+ * @param entities Entity count the body was set up with
+ * @param body The code to time
+ * @param minSeconds Minimum duration of the measured batch
+ */
+BenchmarkResult measure(const std::string &name, size_t entities, const BenchmarkBody &body, double minSeconds);
+
+/**
+ * @brief Writes results as a JSON array of objects
+ * @return false if the file could not be written
+ */
+bool writeJson(const std::string &path, const std::vector<BenchmarkResult> &results);
+
+/**
+ * @brief Writes results as CSV with a header row (the format readCsv() and --baseline read)
+ * @return false if the file could not be written
+ */
+bool writeCsv(const std::string &path, const std::vector<BenchmarkResult> &results);
+
+/**
+ * @brief Reads results written by writeCsv()
+ * @return false if the file could not be read
+ */
+bool readCsv(const std::string &path, std::vector<BenchmarkResult> &results);
+
+/**
+ * @brief Prints each result next to its baseline and flags the ones that got slower
+ * @details Results without a baseline entry are reported but never count as regressions.
+ *
+ * @param results The current run
+ * @param baseline The stored run to compare against
+ * @param tolerance Allowed slowdown as a fraction (0.1 = 10%)
+ * @return Number of results slower than the baseline by more than the tolerance
+ */
+int compareToBaseline(const std::vector<BenchmarkResult> &results, const std::vector<BenchmarkResult> &baseline,
+                      double tolerance);
+
+#endif //GRAPHICS_BENCHMARK_H
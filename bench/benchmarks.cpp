@@ -0,0 +1,495 @@
+// Microbenchmarks for the game's hot paths, run without a window or GL context.
+//
+// Usage: benchmarks [--filter NAME] [--max-entities N] [--min-time SECONDS]
+//                   [--json PATH] [--csv PATH] [--baseline PATH] [--tolerance PERCENT]
+//
+// Every benchmark runs at 10, 100, 1k, 10k, 100k and 1M entities. With --baseline the run is
+// compared against a CSV written earlier with --csv, and the exit code is 1 if anything got
+// slower than the tolerance allows. The aabb_*, sweep and grid_* benchmarks check their results
+// against a brute force reference before timing, and the exit code is 1 if they disagree.
+// Regenerate bench/baseline.csv from a Release build with
+//     benchmarks --csv ../bench/baseline.csv
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "../src/game/collision.h"
+#include "../src/game/spatialGrid.h"
+#include "../src/game/world.h"
+#include "../src/shapes/rect.h"
+#include "../src/font/textLayout.h"
+
+namespace {
+    /// @brief Size of the game window, which is also the play field
+    const vec2 FIELD_SIZE = {800, 600};
+
+    /// @brief Where the player waits in the safe zone, so collision checks never hit anything
+    const vec2 SAFE_POS = {30, 300};
+
+    const size_t ENTITY_COUNTS[] = {10, 100, 1000, 10000, 100000, 1000000};
+
+    /// @brief Set when a kernel disagrees with its reference implementation
+    bool verificationFailed = false;
+
+    /// @brief Shapes only reference their shader, so an uncompiled one is enough off the GPU
+    Shader shader;
+
+    struct Options {
+        std::string filter;
+        size_t maxEntities = 1000000;
+        double minSeconds = 0.1;
+        std::string jsonPath;
+        std::string csvPath;
+        std::string baselinePath;
+        double tolerance = 0.1;
+    };
+
+    void printUsage() {
+        std::cout << "Usage: benchmarks [options]\n"
+                     "  --filter NAME        only run benchmarks whose name contains NAME\n"
+                     "  --max-entities N     skip entity counts above N (default 1000000)\n"
+                     "  --min-time SECONDS   minimum measured time per result (default 0.1)\n"
+                     "  --json PATH          write the results as JSON\n"
+                     "  --csv PATH           write the results as CSV (usable as a baseline)\n"
+                     "  --baseline PATH      compare against a CSV baseline, exit 1 on regressions\n"
+                     "  --tolerance PERCENT  allowed slowdown against the baseline (default 10)\n";
+    }
+
+    bool parseOptions(int argc, char *argv[], Options &options) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--help") {
+                printUsage();
+                return false;
+            } else if (!hasValue) {
+                std::cout << "ERROR::BENCHMARK: Missing value for " << arg << std::endl;
+                printUsage();
+                return false;
+            } else if (arg == "--filter") {
+                options.filter = argv[++i];
+            } else if (arg == "--max-entities") {
+                options.maxEntities = std::strtoul(argv[++i], nullptr, 10);
+            } else if (arg == "--min-time") {
+                options.minSeconds = std::atof(argv[++i]);
+            } else if (arg == "--json") {
+                options.jsonPath = argv[++i];
+            } else if (arg == "--csv") {
+                options.csvPath = argv[++i];
+            } else if (arg == "--baseline") {
+                options.baselinePath = argv[++i];
+            } else if (arg == "--tolerance") {
+                options.tolerance = std::atof(argv[++i]) / 100.0;
+            } else {
+                std::cout << "ERROR::BENCHMARK: Unknown option " << arg << std::endl;
+                printUsage();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief A glyph table with every character the same size, like a monospace font
+    GlyphTable syntheticGlyphs() {
+        GlyphTable glyphs;
+        for (unsigned int c = 0; c < GLYPH_COUNT; c++) {
+            float u = static_cast<float>(c % 16) / 16;
+            float v = static_cast<float>(c / 16) / 8;
+            glyphs[c] = {{u, v}, {u + 1.0f / 16, v + 1.0f / 8}, {16, 24}, {1, 20}, 18 << 6};
+        }
+        return glyphs;
+    }
+
+    /// @brief Entities scattered over the play field, as structure-of-arrays for Collision
+    struct BoxArrays {
+        std::vector<float> x, y, width, height;
+    };
+
+    /// @brief Random boxes of 5 to 30 px, some with edges exactly on the player's
+    BoxArrays randomBoxes(size_t entities, const Aabb &player) {
+        BoxArrays boxes;
+        for (size_t i = 0; i < entities; i++) {
+            float width = static_cast<float>(5 + rand() % 26), height = static_cast<float>(5 + rand() % 26);
+            float x = static_cast<float>(rand() % 800), y = static_cast<float>(rand() % 600);
+            // every 16th box touches the player's right edge, to check the edges count as overlap
+            if (i % 16 == 15)
+                x = player.right + width / 2;
+            boxes.x.push_back(x);
+            boxes.y.push_back(y);
+            boxes.width.push_back(width);
+            boxes.height.push_back(height);
+        }
+        return boxes;
+    }
+
+    /// @brief Checks a kernel's mask against Collision::overlapsReference() for every entity
+    bool verifyKernel(CollisionKernel kernel, const Aabb &player, const BoxArrays &boxes) {
+        size_t count = boxes.x.size();
+        std::vector<uint64_t> mask(Collision::maskWords(count));
+        size_t hits = Collision::overlapMask(kernel, player, boxes.x.data(), boxes.y.data(), boxes.width.data(),
+                                             boxes.height.data(), count, mask.data());
+        size_t expectedHits = 0;
+        for (size_t i = 0; i < count; i++) {
+            bool expected = Collision::overlapsReference(player, boxes.x[i], boxes.y[i], boxes.width[i], boxes.height[i]);
+            bool actual = (mask[i / 64] >> (i % 64)) & 1;
+            expectedHits += expected;
+            if (expected != actual) {
+                std::cout << "ERROR::BENCHMARK: " << Collision::getKernelName(kernel) << " kernel reports "
+                          << actual << " for entity " << i << " of " << count << ", reference says " << expected << std::endl;
+                return false;
+            }
+        }
+        if (hits != expectedHits) {
+            std::cout << "ERROR::BENCHMARK: " << Collision::getKernelName(kernel) << " kernel counts " << hits
+                      << " hits for " << count << " entities, reference counts " << expectedHits << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Benchmark of one collision kernel; skipped when the CPU lacks it
+    BenchmarkCase aabbCase(CollisionKernel kernel) {
+        return {std::string("aabb_") + Collision::getKernelName(kernel), [kernel](size_t entities) -> BenchmarkBody {
+            if (!Collision::isSupported(kernel))
+                return nullptr;
+            struct State {
+                BoxArrays boxes;
+                std::vector<uint64_t> mask;
+            };
+            // a player sized box in the middle of the field, so a few entities hit it
+            const Aabb player = {392.5f, 407.5f, 292.5f, 307.5f};
+            auto state = std::make_shared<State>();
+            state->boxes = randomBoxes(entities, player);
+            state->mask.resize(Collision::maskWords(entities));
+            if (!verifyKernel(kernel, player, state->boxes))
+                verificationFailed = true;
+            return [state, kernel, player, entities]() {
+                const BoxArrays &boxes = state->boxes;
+                doNotOptimize(Collision::overlapMask(kernel, player, boxes.x.data(), boxes.y.data(),
+                                                     boxes.width.data(), boxes.height.data(), entities,
+                                                     state->mask.data()));
+            };
+        }};
+    }
+
+    /// @brief Entities of 5 to 30 px at one per 400 square pixels, so density stays the same at every count
+    struct GridWorld {
+        vec2 size;
+        EntityStore store;
+    };
+
+    GridWorld gridWorld(size_t entities) {
+        GridWorld world;
+        float side = std::max(100.0f, std::sqrt(static_cast<float>(entities) * 400));
+        world.size = {side, side};
+        world.store.reserve(entities);
+        int range = static_cast<int>(side);
+        for (size_t i = 0; i < entities; i++) {
+            vec2 pos = {rand() % range, rand() % range};
+            vec2 size = {5 + rand() % 26, 5 + rand() % 26};
+            world.store.add(pos, size, vec2(0), vec4(1));
+        }
+        return world;
+    }
+
+    /// @brief Checks SpatialGrid::queryBox() and findPairs() against testing every entity (and pair)
+    bool verifyGrid(const SpatialGrid &grid, const EntityStore &store, const Aabb &box) {
+        std::vector<uint32_t> found;
+        grid.queryBox(box, found);
+        std::sort(found.begin(), found.end());
+        std::vector<uint32_t> expected;
+        for (size_t i = 0; i < store.size(); i++) {
+            if (Collision::overlapsReference(box, store.x[i], store.y[i], store.width[i], store.height[i]))
+                expected.push_back(static_cast<uint32_t>(i));
+        }
+        if (found != expected) {
+            std::cout << "ERROR::BENCHMARK: grid query found " << found.size() << " entities, expected "
+                      << expected.size() << std::endl;
+            return false;
+        }
+
+        // pairs are checked by brute force only where that stays quick
+        if (store.size() > 2000)
+            return true;
+        std::vector<std::pair<uint32_t, uint32_t>> pairs, expectedPairs;
+        grid.findPairs(pairs);
+        std::sort(pairs.begin(), pairs.end());
+        for (uint32_t a = 0; a < store.size(); a++) {
+            Aabb boxA = {store.x[a] - store.width[a] / 2, store.x[a] + store.width[a] / 2,
+                         store.y[a] - store.height[a] / 2, store.y[a] + store.height[a] / 2};
+            for (uint32_t b = a + 1; b < store.size(); b++) {
+                if (Collision::overlapsReference(boxA, store.x[b], store.y[b], store.width[b], store.height[b]))
+                    expectedPairs.emplace_back(a, b);
+            }
+        }
+        if (pairs != expectedPairs) {
+            std::cout << "ERROR::BENCHMARK: grid found " << pairs.size() << " pairs, expected "
+                      << expectedPairs.size() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Sets up a grid benchmark: a constant density world, its grid, and a verification run
+    template<typename Body>
+    BenchmarkBody gridCase(size_t entities, Body body) {
+        struct State {
+            GridWorld world;
+            SpatialGrid grid;
+            std::vector<uint32_t> found;
+            std::vector<std::pair<uint32_t, uint32_t>> pairs;
+        };
+        GridWorld world = gridWorld(entities);
+        auto state = std::make_shared<State>(State{world, SpatialGrid(world.size, World::GRID_CELL_SIZE), {}, {}});
+        state->grid.build(state->world.store);
+        vec2 center = state->world.size / 2.0f;
+        if (!verifyGrid(state->grid, state->world.store, {center.x - 7.5f, center.x + 7.5f, center.y - 7.5f, center.y + 7.5f}))
+            verificationFailed = true;
+        return [state, body]() { body(*state); };
+    }
+
+    /// @brief A box and its motion over one tick
+    struct MovingBox {
+        Aabb box;
+        vec2 motion;
+    };
+
+    /// @brief Returns the box moved by a fraction t of its motion
+    Aabb boxAt(const MovingBox &moving, float t) {
+        vec2 offset = moving.motion * t;
+        return {moving.box.left + offset.x, moving.box.right + offset.x, moving.box.bottom + offset.y, moving.box.top + offset.y};
+    }
+
+    /// @brief Returns true if the boxes overlap at time t (edges included)
+    bool overlapAt(const MovingBox &a, const MovingBox &b, float t) {
+        Aabb boxA = boxAt(a, t), boxB = boxAt(b, t);
+        return boxA.left <= boxB.right && boxA.right >= boxB.left && boxA.bottom <= boxB.top && boxA.top >= boxB.bottom;
+    }
+
+    /// @brief Checks Collision::sweep() against sampling the tick at fine steps
+    /// @details Sampling can miss a graze the sweep finds, so it only checks that every sampled
+    /// contact is found no later than sampled, and that the boxes touch at each reported time.
+    bool verifySweep(const MovingBox &a, const MovingBox &b) {
+        const int STEPS = 256;
+        const float EPSILON = 1e-3f;
+        float timeOfImpact = 2;
+        bool hit = Collision::sweep(a.box, a.motion, b.box, b.motion, timeOfImpact);
+        for (int step = 0; step <= STEPS; step++) {
+            float t = static_cast<float>(step) / STEPS;
+            if (!overlapAt(a, b, t))
+                continue;
+            if (!hit || timeOfImpact > t + EPSILON) {
+                std::cout << "ERROR::BENCHMARK: sweep missed a contact at t = " << t << std::endl;
+                return false;
+            }
+            break;
+        }
+        if (hit) {
+            // nudge the boxes a little further along, so rounding at the exact contact cannot fail the check
+            MovingBox grownA = {{a.box.left - EPSILON, a.box.right + EPSILON, a.box.bottom - EPSILON, a.box.top + EPSILON}, a.motion};
+            if (timeOfImpact < 0 || timeOfImpact > 1 || !overlapAt(grownA, b, timeOfImpact)) {
+                std::cout << "ERROR::BENCHMARK: sweep reports a contact at t = " << timeOfImpact
+                          << " where the boxes do not touch" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief A player sized box and an enemy, moving up to 60 px per tick (Death speed at 20 Hz)
+    std::pair<MovingBox, MovingBox> randomSweep() {
+        auto randomMotion = []() { return vec2{rand() % 121 - 60, rand() % 121 - 60}; };
+        vec2 playerPos = {rand() % 200, rand() % 200}, enemyPos = {rand() % 200, rand() % 200};
+        MovingBox player = {{playerPos.x - 7.5f, playerPos.x + 7.5f, playerPos.y - 7.5f, playerPos.y + 7.5f}, randomMotion()};
+        MovingBox enemy = {{enemyPos.x - 7.5f, enemyPos.x + 7.5f, enemyPos.y - 7.5f, enemyPos.y + 7.5f}, randomMotion()};
+        return {player, enemy};
+    }
+
+    /// @brief Sets up the sweep benchmark, verifying every pair and a known tunneling case first
+    BenchmarkBody sweepCase(size_t entities) {
+        // an enemy crossing a still player in one tick is apart from it at both ends of the tick
+        MovingBox player = {{100, 115, 100, 115}, {0, 0}};
+        MovingBox enemy = {{60, 75, 100, 115}, {60, 0}};
+        float timeOfImpact;
+        if (overlapAt(player, enemy, 0) || overlapAt(player, enemy, 1)
+            || !Collision::sweep(player.box, player.motion, enemy.box, enemy.motion, timeOfImpact)) {
+            std::cout << "ERROR::BENCHMARK: sweep misses an enemy passing through the player" << std::endl;
+            verificationFailed = true;
+        }
+
+        auto pairs = std::make_shared<std::vector<std::pair<MovingBox, MovingBox>>>();
+        for (size_t i = 0; i < entities; i++) {
+            pairs->push_back(randomSweep());
+            if (i < 100000 && !verifySweep(pairs->back().first, pairs->back().second))
+                verificationFailed = true;
+        }
+        return [pairs]() {
+            size_t hits = 0;
+            for (const auto &pair : *pairs) {
+                float timeOfImpact;
+                hits += Collision::sweep(pair.first.box, pair.first.motion, pair.second.box, pair.second.motion, timeOfImpact);
+            }
+            doNotOptimize(hits);
+        };
+    }
+
+    /**
+     * @brief Every benchmark, keyed by the hot path it stands in for
+     * @details Each setup owns its state through a shared_ptr captured by the body.
+     */
+    std::vector<BenchmarkCase> benchmarkCases() {
+        return {
+            // Engine::update: every enemy moves one tick
+            {"enemy_movement", [](size_t entities) -> BenchmarkBody {
+                auto world = std::make_shared<World>(FIELD_SIZE);
+                world->spawn(0, static_cast<int>(entities), 1);
+                return [world]() { world->moveEnemies(1.0f / 60); };
+            }},
+            // Engine::collectingSupplies and Engine::deadByEnemy, half supplies and half enemies
+            {"collision", [](size_t entities) -> BenchmarkBody {
+                auto world = std::make_shared<World>(FIELD_SIZE);
+                world->spawn(static_cast<int>(entities / 2), static_cast<int>(entities - entities / 2), 1);
+                auto player = std::make_shared<Rect>(shader, SAFE_POS, vec2{15, 15}, color{0, 0, 1, 1});
+                return [world, player]() {
+                    doNotOptimize(world->collectSupplies(*player, SAFE_POS));
+                    doNotOptimize(world->hitsEnemy(*player, SAFE_POS));
+                };
+            }},
+            // The same with the player sweeping across the whole field in one tick, so the queries find
+            // supplies and enemies; collected supplies are restored so every iteration picks them up
+            {"collision_sweep", [](size_t entities) -> BenchmarkBody {
+                auto world = std::make_shared<World>(FIELD_SIZE);
+                world->spawn(static_cast<int>(entities / 2), static_cast<int>(entities - entities / 2), 1);
+                world->moveEnemies(1.0f / 60);
+                vec2 start = {World::SAFE_ZONE_WIDTH, FIELD_SIZE.y / 2}, end = {FIELD_SIZE.x - 20, FIELD_SIZE.y / 2};
+                auto player = std::make_shared<Rect>(shader, end, vec2{15, 15}, color{0, 0, 1, 1});
+                return [world, player, start]() {
+                    doNotOptimize(world->collectSupplies(*player, start));
+                    doNotOptimize(world->hitsEnemy(*player, start));
+                    world->restoreSupplies();
+                };
+            }},
+            // Collision::overlapMask with each kernel, checked against the reference first
+            aabbCase(CollisionKernel::Scalar),
+            aabbCase(CollisionKernel::Sse2),
+            aabbCase(CollisionKernel::Avx2),
+            // Collision::sweep over pairs of moving boxes, checked against sampling each tick first
+            {"sweep", sweepCase},
+            // SpatialGrid at constant density: a rebuild, a player sized query and all overlapping pairs
+            {"grid_build", [](size_t entities) -> BenchmarkBody {
+                return gridCase(entities, [](auto &state) { state.grid.build(state.world.store); });
+            }},
+            {"grid_query", [](size_t entities) -> BenchmarkBody {
+                return gridCase(entities, [](auto &state) {
+                    vec2 center = state.world.size / 2.0f;
+                    state.found.clear();
+                    state.grid.queryBox({center.x - 7.5f, center.x + 7.5f, center.y - 7.5f, center.y + 7.5f}, state.found);
+                    doNotOptimize(state.found.data());
+                });
+            }},
+            {"grid_pairs", [](size_t entities) -> BenchmarkBody {
+                return gridCase(entities, [](auto &state) {
+                    state.pairs.clear();
+                    state.grid.findPairs(state.pairs);
+                    doNotOptimize(state.pairs.data());
+                });
+            }},
+            // Rect::isOverlapping against scattered rectangles
+            {"rect_overlap", [](size_t entities) -> BenchmarkBody {
+                auto rects = std::make_shared<std::vector<Rect>>();
+                rects->reserve(entities);
+                for (size_t i = 0; i < entities; i++)
+                    rects->emplace_back(shader, vec2{rand() % 800, rand() % 600}, vec2{15, 15}, color{1, 0, 0, 1});
+                auto player = std::make_shared<Rect>(shader, vec2{400, 300}, vec2{15, 15}, color{0, 0, 1, 1});
+                return [rects, player]() {
+                    size_t hits = 0;
+                    for (const Rect &rect : *rects)
+                        hits += player->isOverlapping(rect);
+                    doNotOptimize(hits);
+                };
+            }},
+            // FontRenderer::renderText layout, as lines of 64 characters
+            {"text_layout", [](size_t entities) -> BenchmarkBody {
+                struct State {
+                    GlyphTable glyphs = syntheticGlyphs();
+                    std::string text;
+                    std::vector<TextVertex> vertices;
+                };
+                auto state = std::make_shared<State>();
+                for (size_t i = 0; i < entities; i++)
+                    state->text.push_back(static_cast<char>(' ' + i % 95));
+                return [state]() {
+                    std::string_view text = state->text;
+                    for (size_t first = 0; first < text.size(); first += 64) {
+                        state->vertices.clear();
+                        layoutText(state->glyphs, text.substr(first, 64), 10, 300, .55f,
+                                   glm::vec4(1), TextAlign::Left, state->vertices);
+                        doNotOptimize(state->vertices.data());
+                    }
+                };
+            }},
+            // Engine::createSupplies: spawning a level and clearing it again on restart
+            {"spawn", [](size_t entities) -> BenchmarkBody {
+                auto world = std::make_shared<World>(FIELD_SIZE);
+                return [world, entities]() {
+                    world->spawn(static_cast<int>(entities / 2), static_cast<int>(entities - entities / 2), 1);
+                    world->clear();
+                };
+            }},
+        };
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    std::vector<BenchmarkResult> results;
+    std::printf("%-16s %10s %12s %14s %14s\n", "benchmark", "entities", "iterations", "ns/op", "ns/entity");
+    for (const BenchmarkCase &benchmark : benchmarkCases()) {
+        if (benchmark.name.find(options.filter) == std::string::npos)
+            continue;
+        for (size_t entities : ENTITY_COUNTS) {
+            if (entities > options.maxEntities)
+                continue;
+            // same spawn positions on every run
+            srand(1);
+            BenchmarkBody body = benchmark.setup(entities);
+            if (!body)
+                continue;
+            BenchmarkResult result = measure(benchmark.name, entities, body, options.minSeconds);
+            std::printf("%-16s %10zu %12zu %14.1f %14.3f\n", result.name.c_str(), result.entities,
+                        result.iterations, result.nsPerOp, result.nsPerEntity);
+            results.push_back(result);
+        }
+    }
+
+    if (verificationFailed)
+        return 1;
+    if (!options.jsonPath.empty() && !writeJson(options.jsonPath, results))
+        return 1;
+    if (!options.csvPath.empty() && !writeCsv(options.csvPath, results))
+        return 1;
+
+    if (!options.baselinePath.empty()) {
+        std::vector<BenchmarkResult> baseline;
+        if (!readCsv(options.baselinePath, baseline))
+            return 1;
+        int regressions = compareToBaseline(results, baseline, options.tolerance);
+        if (regressions > 0) {
+            std::cout << regressions << " benchmark(s) regressed by more than "
+                      << options.tolerance * 100 << "%" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
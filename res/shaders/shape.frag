@@ -1,10 +1,10 @@
 #version 330 core
 
-out vec4 FragColor;
+in vec4 shapeColor;
 
-uniform vec4 shapeColor;
+out vec4 FragColor;
 
 void main()
 {
     FragColor = shapeColor;
-}
\ No newline at end of file
+}
@@ -2,10 +2,22 @@
 
 layout (location = 0) in vec2 aPos;
 
-uniform mat4 model;
-uniform mat4 projection;
+// Per-instance attributes (see ShapeRenderer::Instance)
+layout (location = 1) in vec2 instancePos;
+layout (location = 2) in vec2 instanceSize;
+layout (location = 3) in vec4 instanceColor;
+
+out vec4 shapeColor;
+
+// Per-frame constants shared with text.vert (see FrameUniforms)
+layout (std140) uniform FrameData {
+    mat4 projection;
+    vec2 viewportSize;
+    float time;
+};
 
 void main()
 {
-    gl_Position = projection * model * vec4(aPos.x, aPos.y, 0.0, 1.0);
-}
\ No newline at end of file
+    shapeColor = instanceColor;
+    gl_Position = projection * vec4(aPos * instanceSize + instancePos, 0.0, 1.0);
+}
@@ -1,12 +1,21 @@
 #version 330 core
 in vec2 TexCoords;
+in vec4 TextColor;
 out vec4 color;
 
 uniform sampler2D text;
-uniform vec3 textColor;
+// True when the atlas holds signed distance fields instead of coverage
+uniform bool sdf;
 
 void main()
 {    
-    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
-    color = vec4(textColor, 1.0) * sampled;
-}  
\ No newline at end of file
+    float value = texture(text, TexCoords).r;
+    float coverage = value;
+    if (sdf) {
+        // The glyph edge sits at 0.5; smooth over one screen pixel so edges stay sharp at any scale
+        float smoothing = fwidth(value) * 0.5;
+        coverage = smoothstep(0.5 - smoothing, 0.5 + smoothing, value);
+    }
+    vec4 sampled = vec4(1.0, 1.0, 1.0, coverage);
+    color = TextColor * sampled;
+}
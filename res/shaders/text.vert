@@ -1,11 +1,19 @@
 #version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+layout (location = 1) in vec4 vertexColor;
 out vec2 TexCoords;
+out vec4 TextColor;
 
-uniform mat4 projection;
+// Per-frame constants shared with shape.vert (see FrameUniforms)
+layout (std140) uniform FrameData {
+    mat4 projection;
+    vec2 viewportSize;
+    float time;
+};
 
 void main()
 {
     gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
     TexCoords = vertex.zw;
-}  
\ No newline at end of file
+    TextColor = vertexColor;
+}
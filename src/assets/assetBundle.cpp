@@ -0,0 +1,122 @@
+#include "assetBundle.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+AssetBundle::~AssetBundle() {
+    close();
+}
+
+bool AssetBundle::open(const std::string &path) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(AssetBundleHeader))) {
+        ::close(fd);
+        return false;
+    }
+    void *mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+        return false;
+    data = static_cast<const char *>(mapping);
+    size = static_cast<size_t>(info.st_size);
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+    std::streamoff fileSize = file.tellg();
+    if (fileSize < static_cast<std::streamoff>(sizeof(AssetBundleHeader)))
+        return false;
+    buffer.resize(static_cast<size_t>(fileSize));
+    file.seekg(0);
+    if (!file.read(buffer.data(), buffer.size())) {
+        buffer.clear();
+        return false;
+    }
+    data = buffer.data();
+    size = buffer.size();
+#endif
+
+    // Reject bundles from other versions or builds instead of misreading them
+    AssetBundleHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != ASSET_BUNDLE_MAGIC || header.version != ASSET_BUNDLE_VERSION
+        || header.characterSize != sizeof(Character)
+        || sizeof(AssetBundleHeader) + header.entryCount * sizeof(AssetBundleEntry) > size) {
+        std::cout << "ERROR::ASSETS: " << path << " is not a compatible asset bundle" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool AssetBundle::isOpen() const {
+    return data != nullptr;
+}
+
+void AssetBundle::close() {
+#ifndef _WIN32
+    if (data != nullptr)
+        munmap(const_cast<char *>(data), size);
+#endif
+    buffer.clear();
+    data = nullptr;
+    size = 0;
+}
+
+std::string_view AssetBundle::find(std::string_view name) const {
+    if (data == nullptr)
+        return {};
+    AssetBundleHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    const char *table = data + sizeof(AssetBundleHeader);
+    for (uint32_t i = 0; i < header.entryCount; i++) {
+        AssetBundleEntry entry;
+        std::memcpy(&entry, table + i * sizeof(AssetBundleEntry), sizeof(entry));
+        if (name == std::string_view(entry.name, strnlen(entry.name, sizeof(entry.name)))) {
+            if (entry.offset + entry.size > size)
+                return {};
+            return std::string_view(data + entry.offset, entry.size);
+        }
+    }
+    return {};
+}
+
+const char *AssetBundle::findText(std::string_view name) const {
+    // Text assets are baked with their terminating NUL
+    std::string_view asset = find(name);
+    if (asset.empty() || asset.back() != '\0')
+        return nullptr;
+    return asset.data();
+}
+
+const unsigned char *AssetBundle::findFontAtlas(const GlyphTable *&glyphs, FontMode &mode, int &width, int &height) const {
+    std::string_view asset = find(ASSET_FONT_ATLAS);
+    if (asset.size() < sizeof(BakedFontHeader) + sizeof(GlyphTable))
+        return nullptr;
+
+    BakedFontHeader header;
+    std::memcpy(&header, asset.data(), sizeof(header));
+    size_t pixelBytes = static_cast<size_t>(header.width) * header.height;
+    if (header.glyphCount != GLYPH_COUNT || asset.size() < sizeof(BakedFontHeader) + sizeof(GlyphTable) + pixelBytes)
+        return nullptr;
+
+    // The baker aligns every entry to 16 bytes, so the glyph table can be used in place
+    glyphs = reinterpret_cast<const GlyphTable *>(asset.data() + sizeof(BakedFontHeader));
+    mode = static_cast<FontMode>(header.mode);
+    width = static_cast<int>(header.width);
+    height = static_cast<int>(header.height);
+    return reinterpret_cast<const unsigned char *>(asset.data() + sizeof(BakedFontHeader) + sizeof(GlyphTable));
+}
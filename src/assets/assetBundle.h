@@ -0,0 +1,96 @@
+#ifndef GRAPHICS_ASSETBUNDLE_H
+#define GRAPHICS_ASSETBUNDLE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../font/glyphAtlas.h"
+
+/// @brief Identifies a bundle file ("CDAB", little endian).
+const uint32_t ASSET_BUNDLE_MAGIC = 0x42414443;
+
+/// @brief Bumped whenever the layout of the bundle or of baked structs changes.
+const uint32_t ASSET_BUNDLE_VERSION = 1;
+
+/// @brief Name of the baked font atlas entry.
+const char *const ASSET_FONT_ATLAS = "font/atlas";
+
+/// @brief Header at the start of a bundle file.
+struct AssetBundleHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    /// @brief sizeof(Character) when baked; guards against loading a bundle from another build
+    uint32_t characterSize;
+};
+
+/// @brief Table-of-contents entry; entryCount of these follow the header.
+struct AssetBundleEntry {
+    char name[48];
+    uint64_t offset;
+    uint64_t size;
+};
+
+/// @brief Header of the font atlas entry, followed by the GlyphTable and then the atlas pixels.
+struct BakedFontHeader {
+    uint32_t mode;
+    uint32_t width;
+    uint32_t height;
+    uint32_t glyphCount;
+};
+
+/// @brief Read-only view of an asset bundle produced by the assetBaker tool.
+/// @details The file is memory mapped, so looking up an asset returns a pointer straight into the
+/// mapping and nothing is copied or parsed until it is uploaded.
+class AssetBundle {
+public:
+    /// @brief Construct an empty (closed) bundle
+    AssetBundle() = default;
+
+    /// @brief Unmaps the bundle
+    ~AssetBundle();
+
+    AssetBundle(const AssetBundle &) = delete;
+    AssetBundle &operator=(const AssetBundle &) = delete;
+
+    /// @brief Maps a bundle file and validates its header
+    /// @param path The path to the bundle
+    /// @return true if the bundle was opened and matches this build
+    bool open(const std::string &path);
+
+    /// @brief Returns true if a bundle is open
+    bool isOpen() const;
+
+    /// @brief Finds an asset by name
+    /// @param name The name the asset was baked with
+    /// @return The asset's bytes, or an empty view if it does not exist
+    std::string_view find(std::string_view name) const;
+
+    /// @brief Returns a baked text asset (such as shader source) as a NUL-terminated string
+    /// @param name The name the asset was baked with
+    /// @return The text, or nullptr if it does not exist
+    const char *findText(std::string_view name) const;
+
+    /// @brief Returns the baked font atlas
+    /// @param glyphs Set to the glyph table
+    /// @param mode Set to the rasterization mode
+    /// @param width Set to the atlas width in pixels
+    /// @param height Set to the atlas height in pixels
+    /// @return Pointer to the atlas pixels, or nullptr if the bundle has no font
+    const unsigned char *findFontAtlas(const GlyphTable *&glyphs, FontMode &mode, int &width, int &height) const;
+
+private:
+    /// @brief Start and size of the mapped file
+    const char *data = nullptr;
+    size_t size = 0;
+
+    /// @brief Fallback storage on platforms without mmap
+    std::vector<char> buffer;
+
+    /// @brief Releases the mapping
+    void close();
+};
+
+#endif //GRAPHICS_ASSETBUNDLE_H
@@ -0,0 +1,113 @@
+#include "startupLoader.h"
+#include "../shader/shaderManager.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+StartupTimings::StartupTimings() : origin(now()), mainThread(std::this_thread::get_id()) {}
+
+StartupTimings::Clock::time_point StartupTimings::now() {
+    return Clock::now();
+}
+
+void StartupTimings::record(const char *name, Clock::time_point start) {
+    Clock::time_point end = now();
+    Stage stage = {
+        name,
+        std::chrono::duration<double, std::milli>(start - origin).count(),
+        std::chrono::duration<double, std::milli>(end - start).count(),
+        std::this_thread::get_id() == mainThread
+    };
+    std::lock_guard<std::mutex> lock(mutex);
+    stages.push_back(stage);
+}
+
+void StartupTimings::print() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<Stage> sorted = stages;
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Stage &a, const Stage &b) {
+        return a.startMs < b.startMs;
+    });
+
+    double total = 0;
+    std::printf("Startup timings (ms)\n");
+    std::printf("  %-24s %9s %9s  %s\n", "stage", "start", "duration", "thread");
+    for (const Stage &stage : sorted) {
+        std::printf("  %-24s %9.2f %9.2f  %s\n", stage.name, stage.startMs, stage.durationMs,
+                    stage.mainThread ? "main" : "worker");
+        total = std::max(total, stage.startMs + stage.durationMs);
+    }
+    std::printf("  %-24s %9s %9.2f\n", "total", "", total);
+}
+
+StartupLoader::StartupLoader(StartupTimings &timings) : timings(timings) {}
+
+StartupLoader::~StartupLoader() {
+    // the workers write into this object, so never let them outlive it
+    if (pending.valid())
+        pending.wait();
+}
+
+void StartupLoader::start(std::string bundlePath, std::string resourceDir, std::string fontFile, unsigned int fontSize, FontMode fontMode) {
+    pending = std::async(std::launch::async, [=]() {
+        load(bundlePath, resourceDir, fontFile, fontSize, fontMode);
+    });
+}
+
+const StartupAssets &StartupLoader::wait() {
+    if (pending.valid()) {
+        StartupTimings::Scope scope(timings, "wait for workers");
+        pending.get();
+    }
+    return assets;
+}
+
+void StartupLoader::load(const std::string &bundlePath, const std::string &resourceDir, const std::string &fontFile,
+                         unsigned int fontSize, FontMode fontMode) {
+    // Prefer the baked asset bundle: shaders and the glyph atlas come straight out of the mapping
+    {
+        StartupTimings::Scope scope(timings, "map asset bundle");
+        if (bundle.open(bundlePath)) {
+            assets.shapeVertex = bundle.findText("shaders/shape.vert");
+            assets.shapeFragment = bundle.findText("shaders/shape.frag");
+            assets.textVertex = bundle.findText("shaders/text.vert");
+            assets.textFragment = bundle.findText("shaders/text.frag");
+            assets.atlasPixels = bundle.findFontAtlas(assets.glyphs, assets.fontMode, assets.atlasWidth, assets.atlasHeight);
+        }
+    }
+
+    // Anything the bundle is missing comes from the loose files in res/, with the
+    // shader reads and the font rasterization running side by side
+    std::future<void> shaders, font;
+    if (!assets.shapeVertex || !assets.shapeFragment || !assets.textVertex || !assets.textFragment) {
+        shaders = std::async(std::launch::async, [&]() {
+            StartupTimings::Scope scope(timings, "read shader sources");
+            const char *files[4] = {"shaders/shape.vert", "shaders/shape.frag", "shaders/text.vert", "shaders/text.frag"};
+            for (int i = 0; i < 4; i++)
+                shaderSources[i] = ShaderManager::readSource((resourceDir + files[i]).c_str());
+        });
+    }
+    if (assets.atlasPixels == nullptr) {
+        font = std::async(std::launch::async, [&]() {
+            StartupTimings::Scope scope(timings, "rasterize glyph atlas");
+            rasterizeGlyphAtlas(resourceDir + fontFile, fontSize, fontMode, atlas);
+        });
+    }
+
+    if (shaders.valid()) {
+        shaders.get();
+        assets.shapeVertex = shaderSources[0].c_str();
+        assets.shapeFragment = shaderSources[1].c_str();
+        assets.textVertex = shaderSources[2].c_str();
+        assets.textFragment = shaderSources[3].c_str();
+    }
+    if (font.valid()) {
+        font.get();
+        assets.glyphs = &atlas.glyphs;
+        assets.fontMode = atlas.mode;
+        assets.atlasWidth = atlas.width;
+        assets.atlasHeight = atlas.height;
+        assets.atlasPixels = atlas.pixels.data();
+    }
+}
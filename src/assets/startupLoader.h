@@ -0,0 +1,122 @@
+#ifndef GRAPHICS_STARTUPLOADER_H
+#define GRAPHICS_STARTUPLOADER_H
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "assetBundle.h"
+#include "../font/glyphAtlas.h"
+
+/**
+ * @brief Records how long each startup stage took and on which thread
+ * @details Stages may be recorded from any thread. Times are relative to construction.
+ */
+class StartupTimings {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Starts the startup clock
+    StartupTimings();
+
+    /// @brief Records a stage that started at the given time and ends now
+    /// @param name Static string naming the stage
+    /// @param start When the stage started (from now())
+    void record(const char *name, Clock::time_point start);
+
+    /// @brief Returns the current time, for passing to record()
+    static Clock::time_point now();
+
+    /// @brief Prints every stage in start order, followed by the total
+    void print() const;
+
+    /// @brief Records the enclosing scope as a stage
+    class Scope {
+    public:
+        Scope(StartupTimings &timings, const char *name) : timings(timings), name(name), start(now()) {}
+        ~Scope() { timings.record(name, start); }
+    private:
+        StartupTimings &timings;
+        const char *name;
+        Clock::time_point start;
+    };
+
+private:
+    struct Stage {
+        const char *name;
+        double startMs;
+        double durationMs;
+        bool mainThread;
+    };
+
+    Clock::time_point origin;
+    std::thread::id mainThread;
+    mutable std::mutex mutex;
+    std::vector<Stage> stages;
+};
+
+/// @brief CPU-side assets the engine needs before it can draw its first frame.
+/// @details Pointers refer either into the mapped asset bundle or into the loader's own storage,
+/// and stay valid for as long as the StartupLoader is alive.
+struct StartupAssets {
+    const char *shapeVertex = nullptr;
+    const char *shapeFragment = nullptr;
+    const char *textVertex = nullptr;
+    const char *textFragment = nullptr;
+
+    const GlyphTable *glyphs = nullptr;
+    FontMode fontMode = FontMode::Bitmap;
+    int atlasWidth = 0, atlasHeight = 0;
+    const unsigned char *atlasPixels = nullptr;
+};
+
+/**
+ * @brief Loads startup assets on worker threads
+ * @details start() maps the asset bundle on a worker thread. Whatever the bundle does not provide
+ * is produced by further workers in parallel: shader sources are read from res/ and the font is
+ * rasterized with FreeType. No OpenGL calls are made, so the main thread is free to create the
+ * window and context meanwhile, and then uploads the results after wait().
+ */
+class StartupLoader {
+public:
+    /// @brief Construct an idle loader
+    /// @param timings Where the worker threads record their stages (must outlive the loader)
+    explicit StartupLoader(StartupTimings &timings);
+
+    /// @brief Waits for any running workers
+    ~StartupLoader();
+
+    StartupLoader(const StartupLoader &) = delete;
+    StartupLoader &operator=(const StartupLoader &) = delete;
+
+    /// @brief Starts loading in the background
+    /// @param bundlePath The baked asset bundle to try first
+    /// @param resourceDir Directory holding shaders/ and fonts/ when the bundle is missing
+    /// @param fontFile Font file (relative to resourceDir) to rasterize when the bundle has no atlas
+    /// @param fontSize The size to rasterize the font at
+    /// @param fontMode How to rasterize the font
+    void start(std::string bundlePath, std::string resourceDir, std::string fontFile, unsigned int fontSize, FontMode fontMode);
+
+    /// @brief Blocks until loading has finished
+    /// @return The loaded assets
+    const StartupAssets &wait();
+
+private:
+    StartupTimings &timings;
+    std::future<void> pending;
+    StartupAssets assets;
+
+    /// @brief Backing storage for assets that did not come from the bundle
+    AssetBundle bundle;
+    std::string shaderSources[4];
+    GlyphAtlas atlas;
+
+    /// @brief Body of the main worker thread
+    void load(const std::string &bundlePath, const std::string &resourceDir, const std::string &fontFile,
+              unsigned int fontSize, FontMode fontMode);
+};
+
+#endif //GRAPHICS_STARTUPLOADER_H
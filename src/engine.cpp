@@ -1,58 +1,127 @@
 #include "engine.h"
+#include "renderer/glState.h"
+#include "util/profiler.h"
+#include "game/collision.h"
 #include <vector>
+#include <fstream>
+#include <cmath>
+#include <algorithm>
 
 //States represent the screen, and difficulty that is being played
-enum state {start, info, select, playE, playM, playH, playD, play, over, lost};
+// ("selection" rather than "select", which clashes with select() from the POSIX headers)
+enum state {start, info, selection, playE, playM, playH, playD, play, over, lost};
 state screen;
-float speedModifier = 0;
-//for the direction that the enemies are moving, separate y axis and x axis vectors
-vector<bool> xDirection;
-vector<bool> yDirection;
 int lives = 3;
 
+/// @brief Supplies, enemies and enemy speed of a difficulty
+struct Difficulty {
+    int supplies;
+    int enemies;
+    float speed;
+};
+/// @brief One entry per difficulty, in the order of the playE..playD screens
+const Difficulty difficulties[] = {
+    {10, 5, .5},  // Easy
+    {15, 10, 1},  // Medium
+    {20, 15, 3},  // Hard
+    {30, 25, 5},  // Death
+};
+
 // Colors
 color originalFill, hoverFill, pressFill;
 
-Engine::Engine() : keys() {
-    this->initWindow();
+namespace {
+    /// @brief Fills instances with every active entity of a store, drawn between its last two ticks
+    /// @param alpha Fraction of a tick since the last simulated position
+    void buildInstances(const EntityStore &store, float alpha, vector<ShapeRenderer::Instance> &instances) {
+        size_t count = store.size();
+        const float *x = store.x.data(), *y = store.y.data();
+        const float *previousX = store.previousX.data(), *previousY = store.previousY.data();
+        const float *width = store.width.data(), *height = store.height.data();
+        const uint8_t *flags = store.flags.data();
+
+        instances.clear();
+        instances.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            if (!(flags[i] & ENTITY_ACTIVE))
+                continue;
+            vec2 pos = {previousX[i] + (x[i] - previousX[i]) * alpha, previousY[i] + (y[i] - previousY[i]) * alpha};
+            instances.push_back({pos, vec2{width[i], height[i]}, store.color[i]});
+        }
+    }
+}
+
+Engine::Engine(const EngineConfig &config) : config(config), framePacer(config.pacing, config.targetFps) {
+    // File reads and glyph rasterization run on worker threads while the window and context
+    // are created; only the GL uploads in initShaders() happen on this thread
+    startupLoader = make_unique<StartupLoader>(startupTimings);
+    startupLoader->start("assets.bundle", "../res/", "fonts/MxPlus_IBM_BIOS.ttf", 24, FontMode::SDF);
+    {
+        StartupTimings::Scope scope(startupTimings, config.headless ? "create headless context" : "create window");
+        if (this->initWindow() != 0)
+            return;
+    }
     this->initShaders();
-    this->initShapes();
+    {
+        StartupTimings::Scope scope(startupTimings, "create scene");
+        this->initShapes();
+        this->initText();
+    }
+    // Everything has been uploaded, so the bundle mapping and CPU-side atlas can go
+    startupLoader.reset();
+    firstFrameStart = StartupTimings::now();
+    initialized = true;
+
+    if (config.traceLatency)
+        latencyTracer.enable();
+
+    // The simulation clock starts now, so startup is not simulated as one long first frame
+    tickInterval = 1.0 / config.tickRate;
+    lastFrame = context->getTime();
+
+    // A stress session skips the menus and starts playing straight away
+    if (config.stress) {
+        screen = play;
+        createSupplies();
+        // reserve for up to ten minutes at 240 Hz; longer sessions grow the samples as they go
+        frameStats.enable(static_cast<size_t>(std::min(config.duration, 600.0) * 240));
+        stressStart = context->getTime();
+    }
 
     originalFill = {1, 0, 0, 1};
     hoverFill.vec = originalFill.vec + vec4{0.5, 0.5, 0.5, 0};
     pressFill.vec = originalFill.vec - vec4{0.5, 0.5, 0.5, 0};
 }
 
-Engine::~Engine() {}
+Engine::~Engine() {
+    // Shared meshes outlive every shape, so they are freed with the engine
+    MeshRegistry::clear();
+    Profiler::shutdown();
+    latencyTracer.shutdown();
 
-unsigned int Engine::initWindow(bool debug) {
-    // glfw: initialize and configure
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_COCOA_RETINA_FRAMEBUFFER, GLFW_FALSE);
-#endif
-    glfwWindowHint(GLFW_RESIZABLE, false);
+    framePacer.printReport();
+    latencyTracer.printReport(framePacer.getModeName() + ", " + std::to_string(config.tickRate) + " Hz ticks");
+    if (frameStats.isEnabled())
+        printStressReport();
 
-    //size of the window is declared in ene engine.h file
-    window = glfwCreateWindow(width, height, "engine", nullptr, nullptr);
-    glfwMakeContextCurrent(window);
+    // How many binds the state cache kept away from the driver
+    cout << "GL state calls: " << GLState::getIssuedCalls() << " issued, "
+         << GLState::getElidedCalls() << " elided" << endl;
+}
 
-    // glad: load all OpenGL function pointers
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        cout << "Failed to initialize GLAD" << endl;
+unsigned int Engine::initWindow(bool debug) {
+    // A GLFW window, or an offscreen context when running headless
+    context = makePlatformContext(config.headless);
+    //size of the window is declared in ene engine.h file
+    if (!context->create(width, height, "engine"))
         return -1;
-    }
 
     // OpenGL configuration
     glViewport(0, 0, width, height);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glfwSwapInterval(1);
+    GLState::setBlend(true);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    context->setSwapInterval(framePacer.getSwapInterval());
+    context->setInput(&input);
 
     return 0;
 }
@@ -61,472 +130,396 @@ void Engine::initShaders() {
     // load shader manager
     shaderManager = make_unique<ShaderManager>();
 
-    // Load shader into shader manager and retrieve it
-    shapeShader = this->shaderManager->loadShader("../res/shaders/shape.vert", "../res/shaders/shape.frag",  nullptr, "shape");
+    const StartupAssets &assets = startupLoader->wait();
+    {
+        // Both programs are submitted together so the driver can compile them in parallel,
+        // and linked programs are reused from the shader binary cache on later runs
+        StartupTimings::Scope scope(startupTimings, "compile shaders");
+        std::vector<ShaderHandle> handles = shaderManager->loadShadersFromSource({
+            {assets.shapeVertex, assets.shapeFragment, nullptr, "shape"},
+            {assets.textVertex, assets.textFragment, nullptr, "text"}});
+        shapeShader = handles[0];
+        textShader = handles[1];
+    }
+    {
+        // Glyphs are stored as distance fields so the one 24px atlas stays sharp at every scale we draw
+        StartupTimings::Scope scope(startupTimings, "upload glyph atlas");
+        fontRenderer = make_unique<FontRenderer>(shaderManager->getShader(textShader),
+                                                 Font(*assets.glyphs, assets.fontMode, assets.atlasWidth, assets.atlasHeight, assets.atlasPixels));
+    }
+
+    // Configure instanced shape renderer
+    shapeRenderer = make_unique<ShapeRenderer>(shaderManager->getShader(shapeShader));
 
-    // Configure text shader and renderer
-    textShader = shaderManager->loadShader("../res/shaders/text.vert", "../res/shaders/text.frag", nullptr, "text");
-    fontRenderer = make_unique<FontRenderer>(shaderManager->getShader("text"), "../res/fonts/MxPlus_IBM_BIOS.ttf", 24);
+    // Gameplay code only enqueues; the queue decides the draw order and batching
+    renderQueue = make_unique<RenderQueue>(*shapeRenderer, *fontRenderer);
 
-    // Set uniforms
-    textShader.setVector2f("vertex", vec4(100, 100, .5, .5));
-    shapeShader.use();
-    shapeShader.setMatrix4("projection", this->PROJECTION);
+    // Both pipelines read the projection from the shared per-frame uniform block
+    frameUniforms = make_unique<FrameUniforms>();
+    shaderManager->getShader(shapeShader).bindUniformBlock(FrameUniforms::BLOCK_NAME, FrameUniforms::BINDING);
+    shaderManager->getShader(textShader).bindUniformBlock(FrameUniforms::BLOCK_NAME, FrameUniforms::BINDING);
 }
 
 void Engine::initShapes() {
+    // Stress sessions may use a play field larger than the window; the projection then covers all of it
+    vec2 field = {width, height};
+    if (config.stress && config.worldWidth != 0) {
+        field = {config.worldWidth, config.worldHeight};
+        PROJECTION = ortho(0.0f, field.x, 0.0f, field.y, -1.0f, 1.0f);
+    }
+
     // User is spawned in the middle of the left side of the screen
-    user = make_unique<Rect>(shapeShader, vec2{30,height/2}, vec2{15, 15}, color{0.537, 0.811, 0.941, .9});
+    user = make_unique<Rect>(shaderManager->getShader(shapeShader), vec2{30,height/2}, vec2{15, 15}, color{0.537, 0.811, 0.941, .9});
+    previousUserPos = user->getPos();
 
     // Safe zone that makes where enemies and supplies can't spawn or move
-    safeZone = make_unique<Rect>(shapeShader, vec2{30,height/2}, vec2{60, height}, color{0.349, 0.901, 0.349, .3});
+    safeZone = make_unique<Rect>(shaderManager->getShader(shapeShader), vec2{30,field.y/2}, vec2{60, field.y}, color{0.349, 0.901, 0.349, .3});
 
     // All parts of battery, charge1-3 move/change color based on number of lives
-    batteryMain = make_unique<Rect>(shapeShader, vec2{30,height - 90}, vec2{50, 130}, color{0.411, 0.411, 0.411, .75});
-    batteryTop = make_unique<Rect>(shapeShader, vec2{30,height - 19}, vec2{25, 12}, color{0.411, 0.411, 0.411, .75});
-    charge1 = make_unique<Rect>(shapeShader, vec2{30,height - 50}, vec2{40, 40}, color{0.9, 0.9, 0, .3});
-    charge2 = make_unique<Rect>(shapeShader, vec2{30,height - 90}, vec2{40, 40}, color{0.9, 0.9, 0, .3});
-    charge3 = make_unique<Rect>(shapeShader, vec2{30,height - 130}, vec2{40, 40}, color{0.9, 0.9, 0, .3});
+    batteryMain = make_unique<Rect>(shaderManager->getShader(shapeShader), vec2{30,height - 90}, vec2{50, 130}, color{0.411, 0.411, 0.411, .75});
+    batteryTop = make_unique<Rect>(shaderManager->getShader(shapeShader), vec2{30,height - 19}, vec2{25, 12}, color{0.411, 0.411, 0.411, .75});
+    charge1 = make_unique<Rect>(shaderManager->getShader(shapeShader), vec2{30,height - 50}, vec2{40, 40}, color{0.9, 0.9, 0, .3});
+    charge2 = make_unique<Rect>(shaderManager->getShader(shapeShader), vec2{30,height - 90}, vec2{40, 40}, color{0.9, 0.9, 0, .3});
+    charge3 = make_unique<Rect>(shaderManager->getShader(shapeShader), vec2{30,height - 130}, vec2{40, 40}, color{0.9, 0.9, 0, .3});
+
+    // Supplies and enemies are spawned into the world when a difficulty is chosen
+    world = make_unique<World>(field);
+    entityMesh = MeshRegistry::acquire(MeshType::Quad);
+}
+
+void Engine::initText() {
+    // Menu text never changes, so it is laid out once and drawn from retained vertex buffers.
+    // Each line is measured and centered on the middle of the screen.
+    auto centered = [this](vector<TextHandle> &screenText, std::string_view message, float y, float scale) {
+        screenText.push_back(fontRenderer->createText(message, width/2, y, scale, vec3{1, 1, 1}, TextAlign::Center));
+    };
+
+    // Game begins on this screen. Has the general info about the game
+    centered(startText, "Welcome!", height/2 + 150, 1);
+    centered(startText, "In this game, you (the blue box) must go around and", height/2 + 100, .55);
+    centered(startText, "collect supplies (purple boxes) to build your ship ", height/2 + 50, .55);
+    centered(startText, "and fly away! You can control your box using the", height/2, .55);
+    centered(startText, "arrow keys. Be careful collecting though, there are", height/2 - 50, .55);
+    centered(startText, "enemies (red boxes) around that are trying to stop you!", height/2 - 100, .55);
+    centered(startText, "Press c to continue", height/2 - 150, .8);
+
+    // An additional screen giving more info on lives and safe zone
+    centered(infoText, "-= Lives =-", height/2 + 150, 1);
+    centered(infoText, "In this game you will start in a safe zone where no", height/2 + 100, .55);
+    centered(infoText, "enemies will spawn or move to. However, if you are", height/2 + 50, .55);
+    centered(infoText, "outside the zone and you hit an enemy, you will lose a", height/2, .55);
+    centered(infoText, "life. Your lives will be shown in how charged the battery", height/2 - 50, .55);
+    centered(infoText, "in the top right is, and its game over when you run out!", height/2 - 100, .55);
+    centered(infoText, "Press s to start!", height/2 - 150, .8);
+
+    // Gives the user a prompt on what difficulty they want to play on
+    centered(selectText, "-= Press letter for difficulty =-", height/2 + 100, .85);
+    centered(selectText, "E - Easy", height/2 + 50, .7);
+    centered(selectText, "M - Medium", height/2, .7);
+    centered(selectText, "H - Hard", height/2 - 50, .7);
+    centered(selectText, "D - Death", height/2 - 100, .7);
+
+    // End screens
+    centered(overText, "You win!", height/2 + 25, 1);
+    centered(overText, "Press R to go back to start screen", height/2 - 25, .75);
+    centered(lostText, "You LOSE!", height/2 + 25, 1);
+    centered(lostText, "Press R to go back to start screen", height/2 - 25, .75);
 }
 
 void Engine::processInput() {
-    glfwPollEvents();
-
-    // Set keys to true if pressed, false if released
-    for (int key = 0; key < 1024; ++key) {
-        if (glfwGetKey(window, key) == GLFW_PRESS)
-            keys[key] = true;
-        else if (glfwGetKey(window, key) == GLFW_RELEASE)
-            keys[key] = false;
-    }
+    PROFILE_SCOPE("input");
+    FrameStats::Scope stat(frameStats, FrameStats::Input);
+    // Key and cursor events arrive through the context's callbacks during pollEvents()
+    input.beginFrame();
+    context->pollEvents();
+
+    // Start tracing this frame's first key press, and finish traces whose frames the GPU completed
+    latencyTracer.poll();
+    Input::Clock::time_point pressTime;
+    if (input.getFirstPressTime(pressTime))
+        latencyTracer.onInput(pressTime);
 
     // Close window if escape key is pressed
-    if (keys[GLFW_KEY_ESCAPE])
-        glfwSetWindowShouldClose(window, true);
+    if (input.wasPressed(Action::Quit))
+        context->setShouldClose(true);
 
     // Mouse position saved to check for collisions
-    glfwGetCursorPos(window, &MouseX, &MouseY);
+    input.getCursorPos(MouseX, MouseY);
+
+    // F3 toggles the profiler overlay
+    if (input.wasPressed(Action::ToggleProfiler))
+        showProfiler = !showProfiler;
+
+    // Stress sessions have no menus; a script moves the player in tick()
+    if (config.stress)
+        return;
 
     // If we're in the start screen and the user presses c, change screen to info
-    if (keys[GLFW_KEY_C] && screen == start)
+    if (input.wasPressed(Action::Continue) && screen == start)
         screen = info;
 
     // If we're in the start screen and the user presses s, change screen to select
-    if (keys[GLFW_KEY_S] && screen == info)
-        screen = select;
+    if (input.wasPressed(Action::Start) && screen == info)
+        screen = selection;
 
     // If we're in the start screen and the user presses e, change screen to playE
-    if (keys[GLFW_KEY_E] && screen == select) {
+    if (input.wasPressed(Action::Easy) && screen == selection) {
         screen = playE;
         createSupplies();
     }
 
     // If we're in the start screen and the user presses m, change screen to playM
-    if (keys[GLFW_KEY_M] && screen == select) {
+    if (input.wasPressed(Action::Medium) && screen == selection) {
         screen = playM;
         createSupplies();
     }
 
     // If we're in the start screen and the user presses h, change screen to playH
-    if (keys[GLFW_KEY_H] && screen == select) {
+    if (input.wasPressed(Action::Hard) && screen == selection) {
         screen = playH;
         createSupplies();
     }
 
     // If we're in the start screen and the user presses d, change screen to playD
-    if (keys[GLFW_KEY_D] && screen == select) {
+    if (input.wasPressed(Action::Death) && screen == selection) {
         screen = playD;
         createSupplies();
     }
-
-    // If we're in any play screen and an arrow key is pressed, move the user
-    if (keys[GLFW_KEY_UP] && screen != start && screen != select && screen != over && user->getTop() <= height)
-        user->move(vec2(0, 2));
-    if (keys[GLFW_KEY_DOWN] && screen != start && screen != select && screen != over && user->getBottom() >= 0)
-        user->move(vec2(0, -2));
-    if (keys[GLFW_KEY_LEFT] && screen != start && screen != select && screen != over && user->getLeft() >= 0)
-        user->move(vec2(-2, 0));
-    if (keys[GLFW_KEY_RIGHT] && screen != start && screen != select && screen != over && user->getRight() <= width)
-        user->move(vec2(2, 0));
 }
 
 void Engine::update() {
-    // Calculate delta time
-    float currentFrame = glfwGetTime();
-    deltaTime = currentFrame - lastFrame;
+    PROFILE_SCOPE("update");
+    FrameStats::Scope stat(frameStats, FrameStats::Update);
+    // Run as many fixed ticks as fit in the time since the last frame. Long stalls are clamped
+    // so the simulation drops time instead of trying to catch up in one burst.
+    double currentFrame = context->getTime();
+    tickAccumulator += std::min(currentFrame - lastFrame, MAX_FRAME_TIME);
     lastFrame = currentFrame;
-    //this is establishing the movements of the enemies. Alternating between directions based on the integer i being even and odd
-    int i = 0;
-    // Moves enemies left and right OR up and down based on if there spot in the vector is even or odd
-    while(i < enemies.size()){
-        if (i % 2 == 0) {
-            if (xDirection[i] && screen != start && screen != select) {
-                enemies[i]->move(vec2(2 * speedModifier, 0));
-                if (enemies[i]->getPos().x > 790) {
-                    xDirection[i] = false;
-                    cout << "Enemy " << i << " moving left" << endl;
-                }
-            } else if (!xDirection[i]) {
-                enemies[i]->move(vec2(-2 * speedModifier, 0));
-                //cout << enemies[i]->getPos().x << endl;
-                if (enemies[i]->getPos().x < 80) {
-                    xDirection[i] = true;
-                    cout << "Enemy " << i << " moving right" << endl;
-                }
-            }
-        } else {
-            if (yDirection[i] && screen != start && screen != select) {
-                enemies[i]->move(vec2(0, 2 * speedModifier));
-                if (enemies[i]->getPos().y > 580) {
-                    yDirection[i] = false;
-                    cout << "Enemy " << i << " moving down" << endl;
-                }
-            } else if (!yDirection[i]) {
-                enemies[i]->move(vec2(0, -2 * speedModifier));
-                //cout << enemies[i]->getPos().x << endl;
-                if (enemies[i]->getPos().y < 20) {
-                    yDirection[i] = true;
-                    cout << "Enemy " << i << " moving up" << endl;
-                }
-            }
-        }
-        i++;
+    while (tickAccumulator >= tickInterval) {
+        tick();
+        tickAccumulator -= tickInterval;
     }
+    // How far this frame lies between the last two ticks
+    interpolation = static_cast<float>(tickAccumulator / tickInterval);
+}
+
+void Engine::tick() {
+    float dt = static_cast<float>(tickInterval);
+    previousUserPos = user->getPos();
+    if (config.stress)
+        moveStressPlayer();
+    else
+        movePlayer(dt);
+
+    // Enemies move back and forth; the rules live in World so they can run without GL
+    world->moveEnemies(dt);
 
     // Calls checks for if the user is overlapping something
-    collectingSupplies();
-    deadByEnemy();
+    {
+        PROFILE_SCOPE("collision");
+        FrameStats::Scope collisionStat(frameStats, FrameStats::Collision);
+        collectingSupplies();
+        deadByEnemy();
+    }
+    tickCount++;
+    latencyTracer.onTick();
+}
 
+void Engine::movePlayer(float dt) {
+    // If we're in any play screen and a movement key is held, move the user
+    // (menus share keys with WASD, so the user stays put outside of play)
+    if (screen < playE || screen > playD)
+        return;
+    float step = PLAYER_SPEED * dt;
+    if (input.isDown(Action::MoveUp) && user->getTop() <= height)
+        user->move(vec2(0, step));
+    if (input.isDown(Action::MoveDown) && user->getBottom() >= 0)
+        user->move(vec2(0, -step));
+    if (input.isDown(Action::MoveLeft) && user->getLeft() >= 0)
+        user->move(vec2(-step, 0));
+    if (input.isDown(Action::MoveRight) && user->getRight() <= width)
+        user->move(vec2(step, 0));
 }
 
 void Engine::render() {
+    PROFILE_SCOPE("render");
+    // everything up to the swap, which is timed separately
+    FrameStats::Clock::time_point renderStart = FrameStats::Clock::now();
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // Set background color
 
     glClear(GL_COLOR_BUFFER_BIT);
 
-    // Set shader to use for all shapes
-    shapeShader.use();
+    // Upload the constants shared by the shape and text shaders for this frame
+    frameUniforms->update(PROJECTION, vec2(width, height), static_cast<float>(context->getTime()));
+
+    latencyTracer.poll();
 
     // Render differently depending on screen
     switch (screen) {
         // Game begins on this screen. Has the general info about the game
         case start: {
-            string welcome = "Welcome!";
-            string info1 = "In this game, you (the blue box) must go around and";
-            string info2 = "collect supplies (purple boxes) to build your ship ";
-            string info3 = "and fly away! You can control your box using the";
-            string info4 = "arrow keys. Be careful collecting though, there are";
-            string info5 = "enemies (red boxes) around that are trying to stop you!";
-            string begin = "Press c to continue";
-            // (12 * message.length()) is the offset to center text.
-            // 12 pixels is the width of each character scaled by 1.
-            this->fontRenderer->renderText(welcome, width/2 - (12 * welcome.length()), height/2 + 150, 1, vec3{1, 1, 1});
-            this->fontRenderer->renderText(info1, width/2 - (12 * (.55) * info1.length()), height/2 + 100, .55, vec3{1, 1, 1});
-            this->fontRenderer->renderText(info2, width/2 - (12 * (.55) * info2.length()), height/2 + 50, .55, vec3{1, 1, 1});
-            this->fontRenderer->renderText(info3, width/2 - (12 * (.55) * info3.length()), height/2, .55, vec3{1, 1, 1});
-            this->fontRenderer->renderText(info4, width/2 - (12 * (.55) * info4.length()), height/2 - 50, .55, vec3{1, 1, 1});
-            this->fontRenderer->renderText(info5, width/2 - (12 * (.55) * info5.length()), height/2 - 100, .55, vec3{1, 1, 1});
-            this->fontRenderer->renderText(begin, width/2 - (12 * (.8) * begin.length()), height/2 - 150, .8, vec3{1, 1, 1});
+            for (TextHandle text : startText)
+                renderQueue->submitText(text);
             break;
         }
 
         // An additional screen giving more info on lives and safe zone
         case info: {
-            string welcome = "-= Lives =-";
-            string info1 = "In this game you will start in a safe zone where no";
-            string info2 = "enemies will spawn or move to. However, if you are";
-            string info3 = "outside the zone and you hit an enemy, you will lose a";
-            string info4 = "life. Your lives will be shown in how charged the battery";
-            string info5 = "in the top right is, and its game over when you run out!";
-            string begin = "Press s to start!";
-            // (12 * message.length()) is the offset to center text.
-            // 12 pixels is the width of each character scaled by 1.
-            this->fontRenderer->renderText(welcome, width/2 - (12 * welcome.length()), height/2 + 150, 1, vec3{1, 1, 1});
-            this->fontRenderer->renderText(info1, width/2 - (12 * (.55) * info1.length()), height/2 + 100, .55, vec3{1, 1, 1});
-            this->fontRenderer->renderText(info2, width/2 - (12 * (.55) * info2.length()), height/2 + 50, .55, vec3{1, 1, 1});
-            this->fontRenderer->renderText(info3, width/2 - (12 * (.55) * info3.length()), height/2, .55, vec3{1, 1, 1});
-            this->fontRenderer->renderText(info4, width/2 - (12 * (.55) * info4.length()), height/2 - 50, .55, vec3{1, 1, 1});
-            this->fontRenderer->renderText(info5, width/2 - (12 * (.55) * info5.length()), height/2 - 100, .55, vec3{1, 1, 1});
-            this->fontRenderer->renderText(begin, width/2 - (12 * (.8) * begin.length()), height/2 - 150, .8, vec3{1, 1, 1});
+            for (TextHandle text : infoText)
+                renderQueue->submitText(text);
             break;
         }
 
         // Gives the user a prompt on what difficulty they want to play on
-        case select: {
-            string selectMessage = "-= Press letter for difficulty =-";
-            string selectE = "E - Easy";
-            string selectM = "M - Medium";
-            string selectH = "H - Hard";
-            string selectD = "D - Death";
-            // (12 * message.length()) is the offset to center text.
-            // 12 pixels is the width of each character scaled by 1.
-            this->fontRenderer->renderText(selectMessage, width/2 - (12 * (.85) * selectMessage.length()), height/2 + 100, .85, vec3{1, 1, 1});
-            this->fontRenderer->renderText(selectE, width/2 - (12 * (.7) * selectE.length()), height/2 + 50, .7, vec3{1, 1, 1});
-            this->fontRenderer->renderText(selectM, width/2 - (12 * (.7) * selectM.length()), height/2, .7, vec3{1, 1, 1});
-            this->fontRenderer->renderText(selectH, width/2 - (12 * (.7) * selectH.length()), height/2 - 50, .7, vec3{1, 1, 1});
-            this->fontRenderer->renderText(selectD, width/2 - (12 * (.7) * selectD.length()), height/2 - 100, .7, vec3{1, 1, 1});
-            break;
-        }
-
-        // Easy difficulty of game: 10 supplies, 5 enemies, speed modifier of 0.5
-        case playE: {
-            numberOfSupplies = 10;
-            numberOfEnemies = 5;
-
-            // setUniforms and draw all supplies and enemies
-            for(int i = 0; i < numberOfSupplies; i ++){
-                supplies[i]-> setUniforms();
-                supplies[i]-> draw();
-            }
-            for(int i = 0; i < numberOfEnemies; i ++){
-                enemies[i]-> setUniforms();
-                enemies[i]-> draw();
-            }
-            // call setUniforms and draw on all shapes
-            safeZone -> setUniforms();
-            safeZone -> draw();
-            user -> setUniforms();
-            user -> draw();
-            batteryMain -> setUniforms();
-            batteryMain -> draw();
-            batteryTop -> setUniforms();
-            batteryTop -> draw();
-            charge1 -> setUniforms();
-            charge1 -> draw();
-            charge2 -> setUniforms();
-            charge2 -> draw();
-            charge3 -> setUniforms();
-            charge3 -> draw();
-            // Render font on top of user
-            fontRenderer->renderText("YOU", user->getPos().x - 7, user->getPos().y - 1, 0.2, vec3{1, 1, 1});
-            break;
-        }
-
-        // Medium difficulty of game: 15 supplies, 10 enemies, enemy speed modifier of 1
-        case playM: {
-            numberOfSupplies = 15;
-            numberOfEnemies =  10;
-
-            // setUniforms and draw all supplies and enemies
-            for(int i = 0; i < numberOfSupplies; i ++){
-                supplies[i]-> setUniforms();
-                supplies[i]-> draw();
-            }
-            for(int i = 0; i < numberOfEnemies; i ++){
-                enemies[i]-> setUniforms();
-                enemies[i]-> draw();
-            }
-
-            // call setUniforms and draw on all shapes
-            safeZone -> setUniforms();
-            safeZone -> draw();
-            user -> setUniforms();
-            user -> draw();
-            batteryMain -> setUniforms();
-            batteryMain -> draw();
-            batteryTop -> setUniforms();
-            batteryTop -> draw();
-            charge1 -> setUniforms();
-            charge1 -> draw();
-            charge2 -> setUniforms();
-            charge2 -> draw();
-            charge3 -> setUniforms();
-            charge3 -> draw();
-
-            // Render font on top of user
-            fontRenderer->renderText("YOU", user->getPos().x - 7, user->getPos().y - 1, 0.2, vec3{1, 1, 1});
+        case selection: {
+            for (TextHandle text : selectText)
+                renderQueue->submitText(text);
             break;
         }
 
-        // Hard difficulty of game: 20 supplies, 15 enemies, enemy speed modifier of 3
-        case playH: {
-            numberOfSupplies = 20;
-            numberOfEnemies =  15;
-
-            // setUniforms and draw all supplies and enemies
-            for(int i = 0; i < numberOfSupplies; i ++){
-                supplies[i]-> setUniforms();
-                supplies[i]-> draw();
-            }
-            for(int i = 0; i < numberOfEnemies; i ++){
-                enemies[i]-> setUniforms();
-                enemies[i]-> draw();
-            }
-
-            // call setUniforms and draw on all shapes
-            safeZone -> setUniforms();
-            safeZone -> draw();
-            user -> setUniforms();
-            user -> draw();
-            batteryMain -> setUniforms();
-            batteryMain -> draw();
-            batteryTop -> setUniforms();
-            batteryTop -> draw();
-            charge1 -> setUniforms();
-            charge1 -> draw();
-            charge2 -> setUniforms();
-            charge2 -> draw();
-            charge3 -> setUniforms();
-            charge3 -> draw();
-
-            // Render font on top of user
-            fontRenderer->renderText("YOU", user->getPos().x - 7, user->getPos().y - 1, 0.2, vec3{1, 1, 1});
-            break;
-        }
-
-        // Death difficulty of game: 30 supplies, 25 enemies, enemy speed modifier of 5
-        case playD: {
-            numberOfSupplies = 30;
-            numberOfEnemies =  25;
-
-            // setUniforms and draw all supplies and enemies
-            for(int i = 0; i < numberOfSupplies; i ++){
-                supplies[i]-> setUniforms();
-                supplies[i]-> draw();
-            }
-            for(int i = 0; i < numberOfEnemies; i ++){
-                enemies[i]-> setUniforms();
-                enemies[i]-> draw();
+        // Every difficulty and the stress session draw the same scene; only the counts chosen in createSupplies() differ
+        case playE:
+        case playM:
+        case playH:
+        case playD:
+        case play: {
+            // Supplies and enemies, with the safe zone and user blended on top of them.
+            // Moving shapes are drawn between their last two simulated positions.
+            buildInstances(world->getSupplies(), interpolation, supplyInstances);
+            buildInstances(world->getEnemies(), interpolation, enemyInstances);
+            renderQueue->submitInstances(entityMesh, supplyInstances.data(), supplyInstances.size());
+            renderQueue->submitInstances(entityMesh, enemyInstances.data(), enemyInstances.size());
+            renderQueue->submit(*safeZone);
+            vec2 userPos = glm::mix(previousUserPos, user->getPos(), interpolation);
+            renderQueue->submit(*user, userPos);
+
+            // The battery is drawn over the play field (stress sessions have no lives to show)
+            if (screen != play) {
+                renderQueue->submit(*batteryMain, RenderLayer::Hud);
+                renderQueue->submit(*batteryTop, RenderLayer::Hud);
+                renderQueue->submit(*charge1, RenderLayer::Hud);
+                renderQueue->submit(*charge2, RenderLayer::Hud);
+                renderQueue->submit(*charge3, RenderLayer::Hud);
             }
 
-            // call setUniforms and draw on all shapes
-            safeZone -> setUniforms();
-            safeZone -> draw();
-            user -> setUniforms();
-            user -> draw();
-            batteryMain -> setUniforms();
-            batteryMain -> draw();
-            batteryTop -> setUniforms();
-            batteryTop -> draw();
-            charge1 -> setUniforms();
-            charge1 -> draw();
-            charge2 -> setUniforms();
-            charge2 -> draw();
-            charge3 -> setUniforms();
-            charge3 -> draw();
+            PROFILE_COUNT(Entities, supplyInstances.size() + enemyInstances.size() + 1);
 
             // Render font on top of user
-            fontRenderer->renderText("YOU", user->getPos().x - 7, user->getPos().y - 1, 0.2, vec3{1, 1, 1});
+            renderQueue->submitText("YOU", userPos.x, userPos.y - 1, 0.2, vec3{1, 1, 1}, TextAlign::Center);
             break;
         }
         case over: {
-            string message = "You win!";
-            string message2 = "Press R to go back to start screen";
-            // TO DO: Display the message on the screen
-            this->fontRenderer->renderText(message, width/2 - (12 * message.length()), height/2 + 25, 1, vec3{1, 1, 1});
-            this->fontRenderer->renderText(message2, width/2 - (12 * .75 * message2.length()), height/2 - 25, .75, vec3{1, 1, 1});
+            for (TextHandle text : overText)
+                renderQueue->submitText(text);
             restartGame();
             break;
         }
         case lost: {
-            string message = "You LOSE!";
-            string message2 = "Press R to go back to start screen";
-            // TO DO: Display the message on the screen
-            this->fontRenderer->renderText(message, width/2 - (12 * message.length()), height/2 + 25, 1, vec3{1, 1, 1});
-            this->fontRenderer->renderText(message2, width/2 - (12 * .75 * message2.length()), height/2 - 25, .75, vec3{1, 1, 1});
+            for (TextHandle text : lostText)
+                renderQueue->submitText(text);
             restartGame();
             break;
         }
     }
 
-    glfwSwapBuffers(window);
+#ifdef GRAPHICS_PROFILING
+    // Profiler overlay to the right of the battery
+    if (showProfiler)
+        Profiler::drawOverlay(*renderQueue, 80, height - 20);
+#endif
+
+    // Sort and draw everything queued this frame, text on top of the shapes
+    {
+        PROFILE_GPU_SCOPE("draw");
+        renderQueue->flush();
+    }
+    latencyTracer.onSubmit();
+
+    // Capture the final frame of a --frames run for render regression checks
+    if (!config.screenshot.empty() && frameCount + 1 == config.frames)
+        saveScreenshot(config.screenshot);
+
+    frameStats.record(FrameStats::Render, FrameStats::Clock::now() - renderStart);
+    {
+        // the limiter waits here, after the frame is submitted, so waiting overlaps GPU work
+        PROFILE_SCOPE("pace");
+        FrameStats::Scope stat(frameStats, FrameStats::Pace);
+        framePacer.wait();
+    }
+    {
+        PROFILE_SCOPE("swap");
+        FrameStats::Scope stat(frameStats, FrameStats::Swap);
+        context->swapBuffers();
+    }
+    latencyTracer.onSwap();
+    framePacer.endFrame();
+    frameCount++;
+    frameStats.endFrame();
+
+    // Report the startup breakdown once the first frame is on screen
+    if (!startupReported) {
+        startupTimings.record("first frame", firstFrameStart);
+        startupTimings.print();
+        startupReported = true;
+    }
 }
 
 void Engine::deadByEnemy() {
-    for(int i = 0; i < enemies.size(); i ++){
-        if(user->isOverlapping(vec2(enemies[i]->getLeft(), enemies[i]->getTop()))
-           || user->isOverlapping(vec2(enemies[i]->getLeft(), enemies[i]->getBottom()))
-           || user->isOverlapping(vec2(enemies[i]->getRight(), enemies[i]->getTop()))
-           || user->isOverlapping(vec2(enemies[i]->getRight(), enemies[i]->getBottom()))){
-            if (lives > 0) {
-                user->setPos(vec2{30,height/2});
-                lives = lives - 1;
-                if (lives == 0) {
-                    screen = lost;
-                }
-                if (lives == 1)
-                {
-                    charge2->setPosX(-30);
-                    charge3->setColor(color{.3,0,0});
-                }
-                if (lives == 2)
-                {
-                    charge1->setPosX(-30);
-                }
+    if (world->hitsEnemy(*user, previousUserPos)) {
+        // stress sessions count hits but never lose lives, so they always run to the end
+        if (config.stress) {
+            enemyHits++;
+            return;
+        }
+        if (lives > 0) {
+            user->setPos(vec2{30,height/2});
+            // respawning is a jump, not a move to interpolate
+            previousUserPos = user->getPos();
+            lives = lives - 1;
+            if (lives == 0) {
+                screen = lost;
+            }
+            if (lives == 1)
+            {
+                charge2->setPosX(-30);
+                charge3->setColor(color{.3,0,0});
+            }
+            if (lives == 2)
+            {
+                charge1->setPosX(-30);
             }
         }
     }
 }
 
 void Engine::restartGame() {
-    bool stillEnemies = true;
-    bool stillSupplies = true;
-    bool stillDirections1 = true;
-    bool stillDirections2 = true;
-    if (keys[GLFW_KEY_R] && (screen == lost || screen == over)){
+    if (input.wasPressed(Action::Restart) && (screen == lost || screen == over)){
         amountCollected = 0;
         allGone = false;
-        user = make_unique<Rect>(shapeShader, vec2{15,height/2}, vec2{15, 15}, color{0.537, 0.811, 0.941, .9});
-        safeZone = make_unique<Rect>(shapeShader, vec2{30,height/2}, vec2{60, height}, color{0.349, 0.901, 0.349, .3});
-        batteryMain = make_unique<Rect>(shapeShader, vec2{30,height - 90}, vec2{50, 130}, color{0.411, 0.411, 0.411, .75});
-        batteryTop = make_unique<Rect>(shapeShader, vec2{30,height - 19}, vec2{25, 12}, color{0.411, 0.411, 0.411, .75});
-        charge1 = make_unique<Rect>(shapeShader, vec2{30,height - 50}, vec2{40, 40}, color{0.9, 0.9, 0, .3});
-        charge2 = make_unique<Rect>(shapeShader, vec2{30,height - 90}, vec2{40, 40}, color{0.9, 0.9, 0, .3});
-        charge3 = make_unique<Rect>(shapeShader, vec2{30,height - 130}, vec2{40, 40}, color{0.9, 0.9, 0, .3});
+        user = make_unique<Rect>(shaderManager->getShader(shapeShader), vec2{15,height/2}, vec2{15, 15}, color{0.537, 0.811, 0.941, .9});
+        previousUserPos = user->getPos();
+        safeZone = make_unique<Rect>(shaderManager->getShader(shapeShader), vec2{30,height/2}, vec2{60, height}, color{0.349, 0.901, 0.349, .3});
+        batteryMain = make_unique<Rect>(shaderManager->getShader(shapeShader), vec2{30,height - 90}, vec2{50, 130}, color{0.411, 0.411, 0.411, .75});
+        batteryTop = make_unique<Rect>(shaderManager->getShader(shapeShader), vec2{30,height - 19}, vec2{25, 12}, color{0.411, 0.411, 0.411, .75});
+        charge1 = make_unique<Rect>(shaderManager->getShader(shapeShader), vec2{30,height - 50}, vec2{40, 40}, color{0.9, 0.9, 0, .3});
+        charge2 = make_unique<Rect>(shaderManager->getShader(shapeShader), vec2{30,height - 90}, vec2{40, 40}, color{0.9, 0.9, 0, .3});
+        charge3 = make_unique<Rect>(shaderManager->getShader(shapeShader), vec2{30,height - 130}, vec2{40, 40}, color{0.9, 0.9, 0, .3});
         lives = 3;
 
-        while(stillEnemies){
-            if(enemies.size() > 0){
-                enemies.pop_back();
-            }
-            else{
-                stillEnemies = false;
-            }
-        }
-        while(stillSupplies){
-            if(supplies.size() > 0){
-                supplies.pop_back();
-            }
-            else{
-                stillSupplies = false;
-            }
-        }
-        while(stillDirections1){
-            if(xDirection.size() > 0){
-                xDirection.pop_back();
-            }
-            else{
-                stillDirections1 = false;
-            }
-        }
-        while(stillDirections2){
-            if(yDirection.size() > 0){
-                yDirection.pop_back();
-            }
-            else{
-                stillDirections2 = false;
-            }
-        }
-        screen = select;
+        world->clear();
+        screen = selection;
     }
 }
 
 void Engine::collectingSupplies() {
-    for(int i = 0; i < supplies.size(); i ++){
-        if(user->isOverlapping(vec2(supplies[i]->getLeft(), supplies[i]->getTop()))
-        || user->isOverlapping(vec2(supplies[i]->getLeft(), supplies[i]->getBottom()))
-        || user->isOverlapping(vec2(supplies[i]->getRight(), supplies[i]->getTop()))
-        || user->isOverlapping(vec2(supplies[i]->getRight(), supplies[i]->getBottom()))){
-            amountCollected++;
-            cout << "Collecting" << endl;
-            supplies[i]->setPos(vec2{1000,1000});
-            if(amountCollected == supplies.size()){
-                allGone = true;
-            }
-            if(allGone){
-                screen = over;
-            }
-        }
+    int collected = world->collectSupplies(*user, previousUserPos);
+    amountCollected += collected;
+    // only a pickup can win the game; an empty world (menus, after a restart) is not a win
+    if(collected > 0 && static_cast<size_t>(amountCollected) == world->getSupplies().size()){
+        allGone = true;
+    }
+    if(allGone && !config.stress){
+        screen = over;
     }
 }
 
@@ -534,59 +527,70 @@ void Engine::createSupplies() {
     //position for supplies and enemies will be random
 
     //will change based on game mode
-    if (screen == playE) {
-        numberOfSupplies = 10;
-        numberOfEnemies = 5;
-        speedModifier = .5;
-    } else if (screen == playM) {
-        numberOfSupplies = 15;
-        numberOfEnemies = 10;
-        speedModifier = 1;
-    } else if (screen == playH) {
-        numberOfSupplies = 20;
-        numberOfEnemies = 15;
-        speedModifier = 3;
-    } else if (screen == playD) {
-        numberOfSupplies = 30;
-        numberOfEnemies = 25;
-        speedModifier = 5;
+    float speedModifier = 0;
+    if (screen >= playE && screen <= playD) {
+        const Difficulty &difficulty = difficulties[screen - playE];
+        numberOfSupplies = difficulty.supplies;
+        numberOfEnemies = difficulty.enemies;
+        speedModifier = difficulty.speed;
+    } else if (screen == play) {
+        numberOfSupplies = static_cast<int>(config.supplies);
+        numberOfEnemies = static_cast<int>(config.enemies);
+        speedModifier = config.speed;
+    } else {
+        return;
     }
-    if (screen != start && screen != select) {
+    world->spawn(numberOfSupplies, numberOfEnemies, speedModifier);
+}
 
-        for(int i = 0; i < numberOfSupplies; i++){
-            int xSpot = rand() % ((int)width);
-            while (xSpot <= 80 || xSpot >= 785) {
-                xSpot = rand() % ((int)width);
-            }
-            int ySpot = rand() % ((int)height);
-            while (ySpot <= 25 || ySpot >= 585) {
-                ySpot = rand() % ((int)height);
-            }
-            cout << xSpot << " " << ySpot << endl;
-            vec2 suppliesPos = {xSpot, ySpot};
-            supplies.push_back(make_unique<Rect>(shapeShader, suppliesPos, sizeS, purple));
-        }
-        for(int i = 0; i < numberOfEnemies; i++){
-            xDirection.push_back(true);
-            yDirection.push_back(true);
-            int xSpot = rand() % ((int)width);
-            while (xSpot <= 80 || xSpot >= 785) {
-                xSpot = rand() % ((int)width);
-            }
-            int ySpot = rand() % ((int)height);
-            while (ySpot <= 25 || ySpot >= 585) {
-                ySpot = rand() % ((int)height);
-            }
-            cout << i << " " << xSpot << " " << ySpot << endl;
-            vec2 enemyPos = {xSpot, ySpot};
-            enemies.push_back(make_unique<Rect>(shapeShader, enemyPos, sizeE, red));
-        }
-    }
+void Engine::moveStressPlayer() {
+    // A Lissajous sweep over the whole field, advanced per tick so every run follows the same path
+    vec2 field = world->getSize();
+    float t = static_cast<float>(tickCount * tickInterval);
+    user->setPos(vec2{field.x / 2 + field.x * 0.45f * std::sin(t * 0.7f),
+                      field.y / 2 + field.y * 0.45f * std::sin(t * 1.1f)});
+    // the first tick places the player on the path; sweeping it there would collide along the way
+    if (tickCount == 0)
+        previousUserPos = user->getPos();
+}
+
+void Engine::printStressReport() const {
+    size_t frames = frameStats.getFrameCount();
+    double seconds = frameStats.getTotalSeconds();
+    cout << "Stress session: " << numberOfSupplies << " supplies, " << numberOfEnemies << " enemies, speed "
+         << config.speed << ", field " << world->getSize().x << "x" << world->getSize().y
+         << ", " << Collision::getKernelName(Collision::getKernel()) << " collision kernel" << endl;
+    cout << frames << " frames in " << seconds << " s (" << (seconds > 0 ? frames / seconds : 0) << " fps), "
+         << amountCollected << " supplies collected, " << enemyHits << " enemy hits" << endl;
+    frameStats.print();
+}
+
+void Engine::saveScreenshot(const std::string &path) const {
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 3);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
 
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        cout << "ERROR::SCREENSHOT: Failed to write " << path << endl;
+        return;
+    }
+    // binary PPM, rows top to bottom (GL returns them bottom to top)
+    file << "P6\n" << width << " " << height << "\n255\n";
+    for (unsigned int row = height; row-- > 0;)
+        file.write(reinterpret_cast<const char *>(&pixels[static_cast<size_t>(row) * width * 3]), width * 3);
 }
 
 bool Engine::shouldClose() {
-    return glfwWindowShouldClose(window);
+    if (!initialized)
+        return true;
+    // --frames N ends the run on its own, e.g. for unattended headless runs
+    if (config.frames != 0 && frameCount >= config.frames)
+        return true;
+    // --stress sessions run for a fixed time
+    if (config.stress && context->getTime() - stressStart >= config.duration)
+        return true;
+    return context->shouldClose();
 }
 
 GLenum Engine::glCheckError_(const char *file, int line) {
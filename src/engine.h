@@ -6,8 +6,20 @@
 #include <iostream>
 #include <GLFW/glfw3.h>
 
+#include "engineConfig.h"
+#include "platform/platformContext.h"
+#include "platform/framePacer.h"
+#include "input/input.h"
 #include "shader/shaderManager.h"
+#include "shader/frameUniforms.h"
 #include "font/fontRenderer.h"
+#include "assets/assetBundle.h"
+#include "assets/startupLoader.h"
+#include "shapes/shapeRenderer.h"
+#include "renderer/renderQueue.h"
+#include "game/world.h"
+#include "util/frameStats.h"
+#include "util/latencyTracer.h"
 #include "shapes/rect.h"
 #include "shapes/shape.h"
 
@@ -19,8 +31,21 @@ using std::vector, std::unique_ptr, std::make_unique, glm::ortho, glm::mat4, glm
  */
 class Engine {
 private:
-    /// @brief The actual GLFW window.
-    GLFWwindow* window{};
+    /// @brief Startup options (headless mode, frame limit).
+    EngineConfig config;
+
+    /// @brief The window or offscreen context, with its input and timer.
+    /// @details Declared first so it is destroyed last, after every GL object.
+    unique_ptr<PlatformContext> context;
+
+    /// @brief False if the context could not be created; the engine then closes immediately.
+    bool initialized = false;
+
+    /// @brief Holds the --pacing mode and measures how evenly frames are presented.
+    FramePacer framePacer;
+
+    /// @brief Number of frames rendered so far (for --frames).
+    unsigned long frameCount = 0;
 
     ///@brief this is a counter to keep track of how much supplies is collected
     int amountCollected = 0;
@@ -28,18 +53,41 @@ private:
     /// @brief The width and height of the window.
     const unsigned int width = 800, height = 600; // Window dimensions
 
-    /// @brief Keyboard state (True if pressed, false if not pressed).
-    /// @details Index this array with GLFW_KEY_{key} to get the state of a key.
-    bool keys[1024];
+    /// @brief Keyboard and cursor state, filled by the context's event callbacks.
+    /// @details Query it by Action (e.g. input.isDown(Action::MoveUp)) rather than by key.
+    Input input;
+
+    /// @brief Per-stage startup times, printed after the first frame.
+    StartupTimings startupTimings;
+
+    /// @brief Loads shader sources and the glyph atlas on worker threads during startup.
+    /// @details Started in the constructor, consumed by initShaders() and released before the first frame
+    unique_ptr<StartupLoader> startupLoader;
+
+    /// @brief When the constructor finished, and whether the startup report was printed yet
+    StartupTimings::Clock::time_point firstFrameStart;
+    bool startupReported = false;
 
     /// @brief Responsible for loading and storing all the shaders used in the project.
     /// @details Initialized in initShaders()
     unique_ptr<ShaderManager> shaderManager;
 
+    /// @brief Uniform buffer with the per-frame constants (projection, viewport, time).
+    /// @details Initialized in initShaders(), written once at the start of render()
+    unique_ptr<FrameUniforms> frameUniforms;
+
     /// @brief Responsible for rendering text on the screen.
     /// @details Initialized in initShaders()
     unique_ptr<FontRenderer> fontRenderer;
 
+    /// @brief Responsible for drawing all shapes with instanced draw calls.
+    /// @details Initialized in initShaders()
+    unique_ptr<ShapeRenderer> shapeRenderer;
+
+    /// @brief Collects each frame's draw commands and submits them sorted and batched.
+    /// @details Initialized in initShaders(), flushed once at the end of render()
+    unique_ptr<RenderQueue> renderQueue;
+
     // Shapes
     unique_ptr<Shape> user;
     unique_ptr<Shape> safeZone;
@@ -48,24 +96,58 @@ private:
     unique_ptr<Shape> charge1;
     unique_ptr<Shape> charge2;
     unique_ptr<Shape> charge3;
-    vector<unique_ptr<Shape>> supplies;
-    vector<unique_ptr<Shape>> enemies;
     vector<unique_ptr<Shape>> rocketship;
 
+    /// @brief Supplies and enemies, with their movement and collision rules (created in initShapes()).
+    unique_ptr<World> world;
+
+    /// @brief Mesh supplies and enemies are drawn with (acquired in initShapes()).
+    MeshHandle entityMesh = INVALID_MESH;
+
+    /// @brief Interpolated instances of the active supplies and enemies, rebuilt every frame.
+    /// @details Kept as members so the render queue can reference them until it is flushed.
+    vector<ShapeRenderer::Instance> supplyInstances;
+    vector<ShapeRenderer::Instance> enemyInstances;
+
+    // Retained text for each menu screen (created in initText())
+    vector<TextHandle> startText;
+    vector<TextHandle> infoText;
+    vector<TextHandle> selectText;
+    vector<TextHandle> overText;
+    vector<TextHandle> lostText;
+
     //attributes of the vectors
-    vec2 sizeE = {15,15};
-    vec2 sizeS = {10,10};
-    color purple = {1, 0, 1, 1.0f};
-    color red = {1, 0, 0, 1.0f};
     int numberOfSupplies = 0;
     int numberOfEnemies = 0;
     vec2 pos;
 
+    /// @brief The user's position before the last tick, for interpolation.
+    vec2 previousUserPos;
+
+    /// @brief User speed in pixels per second.
+    static constexpr float PLAYER_SPEED = 120;
+
+    /// @brief Longest frame simulated in full; longer stalls drop the remaining time.
+    static constexpr double MAX_FRAME_TIME = 0.25;
+
     bool allGone = false;
 
-    // Shaders
-    Shader shapeShader;
-    Shader textShader;
+    /// @brief Frame and stage times of a --stress session, printed at exit (disabled otherwise).
+    FrameStats frameStats;
+
+    /// @brief Follows key presses until their frame is on screen (--trace-latency, disabled otherwise).
+    LatencyTracer latencyTracer;
+
+    /// @brief When the stress session started, and how many times the scripted player touched an enemy.
+    double stressStart = 0;
+    unsigned long enemyHits = 0;
+
+    // Shaders (handles into shaderManager)
+    ShaderHandle shapeShader;
+    ShaderHandle textShader;
+
+    /// @brief Whether the profiler overlay is shown (toggled with F3).
+    bool showProfiler = false;
 
     double MouseX, MouseY;
     bool mousePressedLastFrame = false;
@@ -77,23 +159,27 @@ private:
 
 public:
     /// @brief Constructor for the Engine class.
-    /// @details Initializes window and shaders.
-    Engine();
+    /// @details Initializes window (or headless context) and shaders.
+    /// @param config Startup options
+    explicit Engine(const EngineConfig &config = EngineConfig());
 
     /// @brief Destructor for the Engine class.
     ~Engine();
 
-    /// @brief Initializes the GLFW window.
+    /// @brief Creates the GLFW window, or the offscreen context in headless mode.
     /// @return 0 if successful, -1 otherwise.
     unsigned int initWindow(bool debug = false);
 
-    /// @brief Loads shaders from files and stores them in the shaderManager.
-    /// @details Renderers are initialized here.
+    /// @brief Compiles the shaders and uploads the font atlas produced by the startup loader.
+    /// @details Renderers are initialized here. Waits for the loader's worker threads to finish.
     void initShaders();
 
     /// @brief Initializes the shapes to be rendered.
     void initShapes();
 
+    /// @brief Creates the retained text for the menu and end screens.
+    void initText();
+
     /// @brief creates the rocketship for the end screens
     void createRocketship();
 
@@ -108,30 +194,51 @@ public:
 
 
     ///@brief creates the supplies object's qualities
+    /// @details Counts and speed come from the difficulty table, or from the config in a stress session
     void createSupplies();
 
+    /// @brief Moves the player along the scripted path of a stress session.
+    void moveStressPlayer();
+
+    /// @brief Prints the stress session's settings and frame statistics.
+    void printStressReport() const;
+
     /// @brief Processes input from the user.
     /// @details (e.g. keyboard input, mouse input, etc.)
     void processInput();
 
     /// @brief Updates the game state.
-    /// @details (e.g. collision detection, delta time, etc.)
+    /// @details Advances the simulation in fixed ticks of 1 / --tick-rate seconds, however long the frame took.
     void update();
 
+    /// @brief Simulates one fixed tick: player and enemy movement, then collisions.
+    void tick();
+
+    /// @brief Moves the user by the arrow keys held down.
+    /// @param dt Length of the tick in seconds
+    void movePlayer(float dt);
+
     /// @brief Renders the game state.
     /// @details Displays/renders objects on the screen.
     void render();
 
-    /* deltaTime variables */
-    float deltaTime = 0.0f; // Time between current frame and last frame
-    float lastFrame = 0.0f; // Time of last frame (used to calculate deltaTime)
+    /// @brief Saves the current back buffer as a binary PPM image.
+    /// @param path The file to write
+    void saveScreenshot(const std::string &path) const;
+
+    /* fixed timestep variables */
+    double tickInterval = 1.0 / 60; // Seconds simulated by each tick (1 / --tick-rate)
+    double lastFrame = 0.0;         // Time of last frame
+    double tickAccumulator = 0.0;   // Time that has passed but not been simulated yet
+    float interpolation = 0.0f;     // Fraction of a tick between the previous and current positions, for rendering
+    unsigned long tickCount = 0;    // Ticks simulated so far
 
     // -----------------------------------
     // Getters
     // -----------------------------------
 
     /// @brief Returns true if the window should close.
-    /// @details (Wrapper for glfwWindowShouldClose()).
+    /// @details True when the window was closed, the --frames limit was reached or startup failed.
     /// @return true if the window should close
     /// @return false if the window should not close
     bool shouldClose();
@@ -140,7 +247,7 @@ public:
     /// We don't have to change this matrix since the screen size never changes.
     /// OpenGL uses the projection matrix to map the 3D scene to a 2D viewport.
     /// The projection matrix transforms coordinates in the camera space into normalized device coordinates (view space to clip space).
-    /// @note The projection matrix is used in the vertex shader.
+    /// @note The projection matrix is uploaded to the FrameData uniform block every frame.
     // 4th quadrant
     mat4 PROJECTION = ortho(0.0f, static_cast<float>(width), 0.0f, static_cast<float>(height), -1.0f, 1.0f);
     // 1st quadrant
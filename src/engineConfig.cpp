@@ -0,0 +1,186 @@
+#include "engineConfig.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace {
+    /// @brief Smallest --world field that leaves room to spawn: World::randomSpawnPos() keeps
+    /// clear of the 80 pixel safe zone, 25 pixels at the bottom and 15 at the other edges
+    const unsigned long MIN_WORLD_WIDTH = 96, MIN_WORLD_HEIGHT = 41;
+
+    /// @brief Most supplies and enemies --stress spawns, together
+    const unsigned long MAX_ENTITIES = 100000000;
+
+    void printUsage(const char *program) {
+        std::cout << "Usage: " << program << " [options]\n"
+                  << "  --headless   Render offscreen (EGL or OSMesa), no display needed\n"
+                  << "  --frames N   Exit after N frames\n"
+                  << "  --screenshot PATH\n"
+                  << "               Save the last frame (requires --frames) as a PPM image\n"
+                  << "  --pacing uncapped|vsync|fps:N\n"
+                  << "               Present as fast as possible, with vsync (default; uncapped when headless), or at N frames per second\n"
+                  << "  --trace-latency\n"
+                  << "               Print input-to-photon latency percentiles at exit\n"
+                  << "  --tick-rate HZ\n"
+                  << "               Simulation ticks per second (default 60)\n"
+                  << "  --stress     Skip the menus and run a scripted load test, printing frame statistics at exit\n"
+                  << "  --supplies N, --enemies N\n"
+                  << "               Entities spawned by --stress (default 10000 each)\n"
+                  << "  --speed X    Enemy speed modifier for --stress (default 1)\n"
+                  << "  --world WxH  Play field size for --stress, at least 96x41 (default: the window size)\n"
+                  << "  --duration S Length of the --stress session in seconds (default 10)\n"
+                  << "  --config PATH\n"
+                  << "               Read options from a file, one per line without the dashes\n"
+                  << "  --help       Show this message" << std::endl;
+    }
+
+    /// @brief Parses a non-negative integer option value
+    bool parseCount(const std::string &text, unsigned long &value) {
+        char *end = nullptr;
+        errno = 0;
+        value = std::strtoul(text.c_str(), &end, 10);
+        return end != text.c_str() && *end == '\0' && text[0] != '-' && errno != ERANGE;
+    }
+
+    /// @brief Parses a positive number option value
+    bool parsePositive(const std::string &text, double &value) {
+        char *end = nullptr;
+        value = std::strtod(text.c_str(), &end);
+        return end != text.c_str() && *end == '\0' && value > 0;
+    }
+
+    /// @brief Parses a WIDTHxHEIGHT option value
+    bool parseSize(const std::string &text, unsigned long &width, unsigned long &height) {
+        size_t separator = text.find('x');
+        return separator != std::string::npos && parseCount(text.substr(0, separator), width)
+               && parseCount(text.substr(separator + 1), height) && width > 0 && height > 0;
+    }
+
+    /// @brief Parses a --pacing option value
+    bool parsePacing(const std::string &text, PacingMode &mode, double &targetFps) {
+        if (text == "uncapped") {
+            mode = PacingMode::Uncapped;
+            return true;
+        }
+        if (text == "vsync") {
+            mode = PacingMode::Vsync;
+            return true;
+        }
+        mode = PacingMode::Limited;
+        return text.compare(0, 4, "fps:") == 0 && parsePositive(text.substr(4), targetFps);
+    }
+
+    /// @brief Reads a config file into "--name value" arguments
+    /// @details Blank lines and lines starting with # are skipped, and "name = value" is accepted too.
+    /// A config file cannot name another one, so files cannot include each other in a loop.
+    bool readConfigFile(const std::string &path, std::vector<std::string> &arguments) {
+        std::ifstream file(path);
+        if (!file) {
+            std::cout << "ERROR::ARGUMENTS: Failed to read config file " << path << std::endl;
+            return false;
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            std::stringstream stream(line);
+            std::string token;
+            bool first = true;
+            while (stream >> token) {
+                if (first && token[0] == '#')
+                    break;
+                if (token == "=")
+                    continue;
+                if (first && token == "config") {
+                    std::cout << "ERROR::ARGUMENTS: " << path << " cannot include another config file" << std::endl;
+                    return false;
+                }
+                arguments.push_back(first ? "--" + token : token);
+                first = false;
+            }
+        }
+        return true;
+    }
+}
+
+bool parseArguments(int argc, char *argv[], EngineConfig &config) {
+    std::vector<std::string> arguments(argv + 1, argv + argc);
+    bool explicitVsync = false;
+    for (size_t i = 0; i < arguments.size(); i++) {
+        const std::string argument = arguments[i];
+        bool hasValue = i + 1 < arguments.size();
+        bool valid = true;
+        if (argument == "--headless") {
+            config.headless = true;
+        } else if (argument == "--trace-latency") {
+            config.traceLatency = true;
+        } else if (argument == "--stress") {
+            config.stress = true;
+        } else if (argument == "--frames") {
+            valid = hasValue && parseCount(arguments[++i], config.frames);
+        } else if (argument == "--pacing") {
+            valid = hasValue && parsePacing(arguments[++i], config.pacing, config.targetFps);
+            explicitVsync = config.pacing == PacingMode::Vsync;
+        } else if (argument == "--tick-rate") {
+            valid = hasValue && parseCount(arguments[++i], config.tickRate) && config.tickRate > 0
+                    && config.tickRate <= 1000;
+        } else if (argument == "--supplies") {
+            valid = hasValue && parseCount(arguments[++i], config.supplies);
+        } else if (argument == "--enemies") {
+            valid = hasValue && parseCount(arguments[++i], config.enemies);
+        } else if (argument == "--speed") {
+            double speed = 0;
+            valid = hasValue && parsePositive(arguments[++i], speed);
+            config.speed = static_cast<float>(speed);
+        } else if (argument == "--duration") {
+            valid = hasValue && parsePositive(arguments[++i], config.duration);
+        } else if (argument == "--world") {
+            valid = hasValue && parseSize(arguments[++i], config.worldWidth, config.worldHeight);
+            if (valid && (config.worldWidth < MIN_WORLD_WIDTH || config.worldHeight < MIN_WORLD_HEIGHT)) {
+                std::cout << "ERROR::ARGUMENTS: --world must be at least " << MIN_WORLD_WIDTH << "x"
+                          << MIN_WORLD_HEIGHT << " to leave room for spawning" << std::endl;
+                return false;
+            }
+        } else if (argument == "--screenshot") {
+            valid = hasValue;
+            if (valid)
+                config.screenshot = arguments[++i];
+        } else if (argument == "--config") {
+            // the file's options are inserted here, so later command line options override them
+            std::vector<std::string> fileArguments;
+            valid = hasValue;
+            if (valid && !readConfigFile(arguments[++i], fileArguments))
+                return false;
+            arguments.insert(arguments.begin() + i + 1, fileArguments.begin(), fileArguments.end());
+        } else {
+            if (argument != "--help")
+                std::cout << "ERROR::ARGUMENTS: Unknown option " << argument << std::endl;
+            printUsage(argv[0]);
+            return false;
+        }
+        if (!valid) {
+            std::cout << "ERROR::ARGUMENTS: Missing or invalid value for " << argument << std::endl;
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    // a headless context has no display to wait for, so report what actually happens
+    if (config.headless && config.pacing == PacingMode::Vsync) {
+        if (explicitVsync)
+            std::cout << "--pacing vsync is ignored without a display; running uncapped" << std::endl;
+        config.pacing = PacingMode::Uncapped;
+    }
+    if (!config.screenshot.empty() && config.frames == 0) {
+        std::cout << "ERROR::ARGUMENTS: --screenshot needs --frames to know which frame to save" << std::endl;
+        return false;
+    }
+    // compare each count first so the sum cannot wrap
+    if (config.supplies > MAX_ENTITIES || config.enemies > MAX_ENTITIES
+        || config.supplies + config.enemies > MAX_ENTITIES) {
+        std::cout << "ERROR::ARGUMENTS: --supplies and --enemies are limited to 100 million entities in total" << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef GRAPHICS_ENGINECONFIG_H
+#define GRAPHICS_ENGINECONFIG_H
+
+#include <string>
+
+#include "platform/framePacer.h"
+
+/**
+ * @brief Startup options for the engine, parsed from the command line
+ */
+struct EngineConfig {
+    /// @brief Render offscreen without a window (--headless)
+    bool headless = false;
+
+    /// @brief Number of frames to run before exiting; 0 runs until the window is closed (--frames N)
+    unsigned long frames = 0;
+
+    /// @brief Where to save the last frame as a PPM image when the --frames limit is reached (--screenshot PATH)
+    std::string screenshot;
+
+    /// @brief How frames are paced, and the frame rate held by PacingMode::Limited (--pacing uncapped|vsync|fps:N)
+    PacingMode pacing = PacingMode::Vsync;
+    double targetFps = 60;
+
+    /// @brief Trace key presses through tick, submit, swap and GPU completion, and print the latency at exit (--trace-latency)
+    bool traceLatency = false;
+
+    /// @brief Simulation ticks per second, independent of the frame rate (--tick-rate HZ)
+    unsigned long tickRate = 60;
+
+    /// @brief Skip the menus and run a scripted load test with the settings below (--stress)
+    bool stress = false;
+
+    /// @brief Number of supplies and enemies spawned for the stress session (--supplies N, --enemies N)
+    unsigned long supplies = 10000;
+    unsigned long enemies = 10000;
+
+    /// @brief Enemy speed modifier for the stress session (--speed X)
+    float speed = 1;
+
+    /// @brief Size of the stress session's play field in pixels; 0 uses the window size (--world WxH)
+    unsigned long worldWidth = 0, worldHeight = 0;
+
+    /// @brief Length of the stress session in seconds (--duration S)
+    double duration = 10;
+};
+
+/**
+ * @brief Parses the command line into a config
+ * @details Prints the usage and returns false on unknown options, missing values or --help.
+ * --config PATH reads further options from a file, one per line without the leading dashes
+ * (e.g. "enemies 100000"); options after it on the command line override the file.
+ *
+ * @param argc Argument count from main()
+ * @param argv Arguments from main()
+ * @param config The config to fill
+ * @return true if the engine should start
+ */
+bool parseArguments(int argc, char *argv[], EngineConfig &config);
+
+#endif //GRAPHICS_ENGINECONFIG_H
@@ -1,77 +1,52 @@
 #include "font.h"
+#include "../renderer/glState.h"
 #include <glad/glad.h>
 
-#include <iostream>
-
-Font::Font(std::string fontPath, unsigned int fontSize) {
-    FT_Library ft;
-
-    // Initialize FreeType library
-    if (FT_Init_FreeType(&ft)) {
-        std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
-    }
-
-    // Load font as face
-    FT_Face face;
-    if (FT_New_Face(ft, fontPath.c_str(), 0, &face)) {
-        std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
-    }
-
-    // Set size to load glyphs as
-    FT_Set_Pixel_Sizes(face, 0, fontSize);
+Font::Font(std::string fontPath, unsigned int fontSize, FontMode mode) : mode(mode) {
+    GlyphAtlas atlas;
+    rasterizeGlyphAtlas(fontPath, fontSize, mode, atlas);
+    Characters = atlas.glyphs;
+    uploadAtlas(atlas.width, atlas.height, atlas.pixels.data());
+}
 
-    // Attempt to load character glyph
-    if (FT_Load_Char(face, 'X', FT_LOAD_RENDER)) {
-        std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
-    }
+Font::Font(const GlyphTable &glyphs, FontMode mode, int atlasWidth, int atlasHeight, const unsigned char *atlasPixels)
+        : Characters(glyphs), mode(mode) {
+    uploadAtlas(atlasWidth, atlasHeight, atlasPixels);
+}
 
+void Font::uploadAtlas(int width, int height, const unsigned char *pixels) {
+    // upload the whole atlas as one texture
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // disable byte-alignment restriction
+    glGenTextures(1, &atlasTexture);
+    GLState::bindTexture(GL_TEXTURE_2D, atlasTexture);
+    glTexImage2D(
+        GL_TEXTURE_2D,
+        0,
+        GL_RED,
+        width,
+        height,
+        0,
+        GL_RED,
+        GL_UNSIGNED_BYTE,
+        pixels
+    );
+
+    // set texture options
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    GLState::bindTexture(GL_TEXTURE_2D, 0);
+}
 
-    // Load first 128 characters of ASCII set
-    for (unsigned char c = 0; c < 128; c++) {
-        // load character glyph 
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-            std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
-            continue;
-        }
-
-        // generate texture
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_RED,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            0,
-            GL_RED,
-            GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer
-        );
-
-        // set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        // now store character for later use
-        Character character = {
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            static_cast<unsigned int>(face->glyph->advance.x)
-        };
-        Characters.insert(std::pair<char, Character>(c, character));
-    }
-    glBindTexture(GL_TEXTURE_2D, 0);
+const GlyphTable &Font::getCharacters() const {
+    return Characters;
+}
 
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
+unsigned int Font::getAtlasTexture() const {
+    return atlasTexture;
 }
 
-std::map<char, Character> Font::getCharacters() const {
-    return Characters;
+FontMode Font::getMode() const {
+    return mode;
 }
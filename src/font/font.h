@@ -1,59 +1,84 @@
 #ifndef GRAPHICS_FONT_H
 #define GRAPHICS_FONT_H
 
-#include <map>
 #include <string>
 
-
 #include <glm/glm.hpp>
 
-#include <ft2build.h>
-#include FT_FREETYPE_H
-
-/**
- * @brief A single character
- * @details This struct is used to store information about a single character
- * 
- * @param TextureID ID handle of the glyph texture
- * @param Size Size of glyph
- * @param Bearing Offset from baseline to left/top of glyph
- * @param Advance Offset to advance to next glyph
- */
-struct Character {
-    unsigned int TextureID;
-    glm::ivec2   Size;
-    glm::ivec2   Bearing;
-    unsigned int Advance;
-};
+#include "glyphAtlas.h"
+#include "textLayout.h"
 
 /**
  * @brief A font
- * @details This class is used to store information about a font
+ * @details This class is used to store information about a font.
+ * All glyphs are packed into a single atlas texture.
  */
 class Font {
     public:
         /**
          * @brief Construct a new Font object
+         * @details Rasterizes the font with FreeType and uploads the atlas
          * 
          * @param fontPath The path to the font file
          * @param fontSize The size of the font
+         * @param mode Whether glyphs are stored as coverage bitmaps or signed distance fields
          */
-        Font(std::string fontPath, unsigned int fontSize);
+        Font(std::string fontPath, unsigned int fontSize, FontMode mode = FontMode::Bitmap);
+
+        /**
+         * @brief Construct a new Font object from a pre-rasterized atlas
+         * @details Used for atlases baked offline into the asset bundle; FreeType is not touched
+         *
+         * @param glyphs The glyph table of the atlas
+         * @param mode How the atlas was rasterized
+         * @param atlasWidth The width of the atlas in pixels
+         * @param atlasHeight The height of the atlas in pixels
+         * @param atlasPixels One byte per pixel, rows top to bottom
+         */
+        Font(const GlyphTable &glyphs, FontMode mode, int atlasWidth, int atlasHeight, const unsigned char *atlasPixels);
 
         
         /**
          * @brief Get the characters
          * 
-         * @return a map of characters
+         * @return the glyph table, indexed by character code
+         */
+        const GlyphTable &getCharacters() const;
+
+        /**
+         * @brief Get the atlas texture
+         *
+         * @return the ID of the texture holding every glyph
          */
-        std::map<char, Character> getCharacters() const;
+        unsigned int getAtlasTexture() const;
+
+        /**
+         * @brief Get the rasterization mode
+         *
+         * @return the mode the atlas was built with
+         */
+        FontMode getMode() const;
 
     private:
         /**
-         * @brief A set of character structs mapped to their ASCII character representations
+         * @brief A table of character structs indexed by their ASCII character codes
+         */
+        GlyphTable Characters = {};
+
+        /**
+         * @brief The texture holding every glyph
          */
-        std::map<char, Character> Characters;
+        unsigned int atlasTexture = 0;
 
+        /**
+         * @brief How the glyphs in the atlas were rasterized
+         */
+        FontMode mode;
+
+        /**
+         * @brief Uploads an atlas image as the font's texture
+         */
+        void uploadAtlas(int width, int height, const unsigned char *pixels);
 };
 
 #endif //GRAPHICS_FONT_H
@@ -1,74 +1,157 @@
 #include "fontRenderer.h"
+#include "../renderer/glState.h"
+#include "../util/profiler.h"
 
+#include <cstddef>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
-FontRenderer::FontRenderer(Shader& shader, std::string fontPath, int fontSize) {
+FontRenderer::FontRenderer(Shader& shader, std::string fontPath, int fontSize, FontMode mode)
+        : font(fontPath, fontSize, mode) {
     this->shader = shader;
     this->initRenderData();
-    Font myFont(fontPath, fontSize);
-    this->font = myFont.getCharacters();
+    this->initShader();
+}
+
+FontRenderer::FontRenderer(Shader& shader, const Font& font) : font(font) {
+    this->shader = shader;
+    this->initRenderData();
+    this->initShader();
+}
+
+void FontRenderer::initShader() {
+    // text.frag reconstructs edges from the distance field when the atlas is an SDF
+    this->shader.use();
+    this->shader.setInteger("sdf", font.getMode() == FontMode::SDF);
 }
 
 FontRenderer::~FontRenderer() {
-    glDeleteVertexArrays(1, &this->VAO);
-    glDeleteBuffers(1, &this->VBO);
+    GLState::deleteVertexArrays(1, &this->VAO);
+    GLState::deleteBuffers(1, &this->VBO);
+    GLuint atlasTexture = font.getAtlasTexture();
+    GLState::deleteTextures(1, &atlasTexture);
+    for (RetainedText &retained : retainedTexts) {
+        GLState::deleteVertexArrays(1, &retained.VAO);
+        GLState::deleteBuffers(1, &retained.VBO);
+    }
 }
 
 void FontRenderer::initRenderData() {
     glGenVertexArrays(1, &this->VAO);
     glGenBuffers(1, &this->VBO);
-    glBindVertexArray(this->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+    GLState::bindVertexArray(this->VAO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, this->VBO);
+    setVertexAttributes();
+    GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::bindVertexArray(0);
+}
+
+void FontRenderer::setVertexAttributes() {
+    // <vec2 pos, vec2 tex> followed by the vertex color
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, pos));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, color));
+}
+
+void FontRenderer::renderText(std::string_view text, float x, float y, float scale, glm::vec3 color, TextAlign align) {
+    addText(text, x, y, scale, color, align);
+    flush();
+}
+
+void FontRenderer::addText(std::string_view text, float x, float y, float scale, glm::vec3 color, TextAlign align) {
+    layoutText(font.getCharacters(), text, x, y, scale, glm::vec4(color, 1.0f), align, vertices);
+}
+
+float FontRenderer::measureText(std::string_view text, float scale) const {
+    return ::measureText(font.getCharacters(), text, scale);
 }
 
-void FontRenderer::renderText(std::string text, float x, float y, float scale, glm::vec3 color) {
+void FontRenderer::flush() {
+    if (vertices.empty())
+        return;
+
     // activate corresponding render state
+    this->shader.use();
+    GLState::activeTexture(GL_TEXTURE0);
+    GLState::bindTexture(GL_TEXTURE_2D, font.getAtlasTexture());
+    GLState::bindVertexArray(this->VAO);
+
+    // grow the VBO geometrically, otherwise orphan it before refilling
+    GLState::bindBuffer(GL_ARRAY_BUFFER, this->VBO);
+    if (vertices.size() > vertexCapacity)
+        vertexCapacity = vertices.capacity();
+    glBufferData(GL_ARRAY_BUFFER, vertexCapacity * sizeof(TextVertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(TextVertex), vertices.data());
+
+    // render every queued glyph quad at once
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
+    PROFILE_COUNT(DrawCalls, 1);
+
+    // bindings are left in place; GLState skips rebinding them next frame
+    vertices.clear();
+}
 
+TextHandle FontRenderer::createText(std::string_view text, float x, float y, float scale, glm::vec3 color, TextAlign align) {
+    RetainedText retained = {std::string(text), x, y, scale, color, align, 0, 0, 0, true};
+    glGenVertexArrays(1, &retained.VAO);
+    glGenBuffers(1, &retained.VBO);
+    GLState::bindVertexArray(retained.VAO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, retained.VBO);
+    setVertexAttributes();
+    GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::bindVertexArray(0);
+
+    retainedTexts.push_back(retained);
+    return static_cast<TextHandle>(retainedTexts.size() - 1);
+}
+
+void FontRenderer::setText(TextHandle handle, std::string_view text) {
+    RetainedText &retained = retainedTexts[handle];
+    if (retained.text == text)
+        return;
+    retained.text.assign(text);
+    retained.dirty = true;
+}
+
+void FontRenderer::drawText(TextHandle handle) {
+    drawTexts(&handle, 1);
+}
+
+void FontRenderer::drawTexts(const TextHandle *handles, size_t count) {
+    // lay texts out again only when their content changed
+    for (size_t i = 0; i < count; i++) {
+        RetainedText &retained = retainedTexts[handles[i]];
+        if (!retained.dirty)
+            continue;
+        retainedVertices.clear();
+        layoutText(font.getCharacters(), retained.text, retained.x, retained.y, retained.scale,
+                   glm::vec4(retained.color, 1.0f), retained.align, retainedVertices);
+        GLState::bindBuffer(GL_ARRAY_BUFFER, retained.VBO);
+        glBufferData(GL_ARRAY_BUFFER, retainedVertices.size() * sizeof(TextVertex), retainedVertices.data(), GL_STATIC_DRAW);
+        GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+        retained.vertexCount = static_cast<GLsizei>(retainedVertices.size());
+        retained.dirty = false;
+    }
+
+    // one program and atlas bind for the whole batch, then a VAO per text
     this->shader.use();
-    glUniformMatrix4fv(glGetUniformLocation(this->shader.ID, "projection"), 1, false, glm::value_ptr(projection));
-    glUniform3f(glGetUniformLocation(this->shader.ID, "textColor"), color.x, color.y, color.z);
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(this->VAO);
-
-    // iterate through all characters
-    std::string::const_iterator c;
-    for (c = text.begin(); c != text.end(); c++) {
-        Character ch = font[*c];
-
-        float xpos = x + ch.Bearing.x * scale;
-        float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
-
-        float w = ch.Size.x * scale;
-        float h = ch.Size.y * scale;
-        // update VBO for each character
-        float vertices[6][4] = {
-            { xpos,     ypos + h,   0.0f, 0.0f },            
-            { xpos,     ypos,       0.0f, 1.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-            { xpos + w, ypos + h,   1.0f, 0.0f }           
-        };
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-        // update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
-        x += (ch.Advance >> 6) * scale; // bitshift by 6 to get value in pixels (2^6 = 64)
+    GLState::activeTexture(GL_TEXTURE0);
+    GLState::bindTexture(GL_TEXTURE_2D, font.getAtlasTexture());
+    for (size_t i = 0; i < count; i++) {
+        const RetainedText &retained = retainedTexts[handles[i]];
+        if (retained.vertexCount == 0)
+            continue;
+        GLState::bindVertexArray(retained.VAO);
+        glDrawArrays(GL_TRIANGLES, 0, retained.vertexCount);
+        PROFILE_COUNT(DrawCalls, 1);
     }
+}
+
+GLuint FontRenderer::getProgram() const {
+    return this->shader.ID;
+}
 
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+GLuint FontRenderer::getAtlasTexture() const {
+    return font.getAtlasTexture();
 }
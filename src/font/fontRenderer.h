@@ -1,13 +1,22 @@
 #ifndef FONTRENDERER_H
 #define FONTRENDERER_H
 
+#include <string_view>
+#include <vector>
+
 #include "../shader/shaderManager.h"
 #include "../shader/shader.h"
 #include "font.h"
 
+/**
+ * @brief Handle to a retained text object created by FontRenderer::createText()
+ */
+using TextHandle = unsigned int;
+
 /**
  * @brief A font renderer
- * @details This class is used to render text using a font
+ * @details This class is used to render text using a font.
+ * Text is laid out into one vertex buffer and drawn from the font atlas with a single draw call per flush.
  */
 class FontRenderer {
     public:
@@ -18,8 +27,18 @@ class FontRenderer {
          * @param shader The shader to use
          * @param fontPath The path to the font file
          * @param fontSize The size of the font
+         * @param mode Whether the font atlas holds coverage bitmaps or signed distance fields
+         */
+        FontRenderer(Shader& shader, std::string fontPath, int fontSize, FontMode mode = FontMode::Bitmap);
+
+        /**
+         * @brief Construct a new Font Renderer object from an already loaded font
+         * @details The renderer takes ownership of the font's atlas texture
+         *
+         * @param shader The shader to use
+         * @param font The font to render with
          */
-        FontRenderer(Shader& shader, std::string fontPath, int fontSize);
+        FontRenderer(Shader& shader, const Font& font);
 
         /**
          * @brief Destroy the Font Renderer object
@@ -28,17 +47,106 @@ class FontRenderer {
         ~FontRenderer();
 
         /**
-         * @brief Renders text on the screen
+         * @brief Renders text on the screen immediately
+         * @details Equivalent to addText() followed by flush()
          * 
          * @param text The text to render
          * @param x The x position of the text
          * @param y The y position of the text
          * @param scale The scale of the text
          * @param color The color of the text
+         * @param align How the text is aligned to x
+         */
+        void renderText(std::string_view text, float x, float y, float scale, glm::vec3 color, TextAlign align = TextAlign::Left);
+
+        /**
+         * @brief Lays out text and queues its glyph quads for the next flush
+         *
+         * @param text The text to render
+         * @param x The x position of the text
+         * @param y The y position of the text
+         * @param scale The scale of the text
+         * @param color The color of the text
+         * @param align How the text is aligned to x
+         */
+        void addText(std::string_view text, float x, float y, float scale, glm::vec3 color, TextAlign align = TextAlign::Left);
+
+        /**
+         * @brief Measures the width of a string in pixels
+         *
+         * @param text The text to measure
+         * @param scale The scale of the text
+         * @return The width of the text when rendered at the given scale
+         */
+        float measureText(std::string_view text, float scale) const;
+
+        /**
+         * @brief Uploads all queued glyph quads and draws them with one draw call
+         */
+        void flush();
+
+        /**
+         * @brief Creates a retained text object whose glyph quads are cached on the GPU
+         * @details Use this for text that rarely changes; drawing it does no layout work
+         *
+         * @param text The text to render
+         * @param x The x position of the text
+         * @param y The y position of the text
+         * @param scale The scale of the text
+         * @param color The color of the text
+         * @param align How the text is aligned to x
+         * @return A handle used to update and draw the text
+         */
+        TextHandle createText(std::string_view text, float x, float y, float scale, glm::vec3 color, TextAlign align = TextAlign::Left);
+
+        /**
+         * @brief Changes the string of a retained text object
+         * @details The text is only laid out again (on its next draw) if the string actually changed
+         *
+         * @param handle The handle returned by createText()
+         * @param text The new text
+         */
+        void setText(TextHandle handle, std::string_view text);
+
+        /**
+         * @brief Draws a retained text object from its cached vertex buffer
+         *
+         * @param handle The handle returned by createText()
+         */
+        void drawText(TextHandle handle);
+
+        /**
+         * @brief Draws several retained text objects, binding the program and atlas only once
+         *
+         * @param handles The handles returned by createText()
+         * @param count The number of handles
          */
-        void renderText(std::string text, float x, float y, float scale, glm::vec3 color);
+        void drawTexts(const TextHandle *handles, size_t count);
+
+        /**
+         * @brief Returns the shader program text is drawn with
+         */
+        GLuint getProgram() const;
+
+        /**
+         * @brief Returns the font atlas texture text is drawn from
+         */
+        GLuint getAtlasTexture() const;
 
     private:
+        /**
+         * @brief Text laid out once and kept in its own vertex buffer
+         */
+        struct RetainedText {
+            std::string text;
+            float x, y, scale;
+            glm::vec3 color;
+            TextAlign align;
+            GLuint VAO, VBO;
+            GLsizei vertexCount;
+            bool dirty;
+        };
+
         /**
          * @brief The shader to use
          */
@@ -50,20 +158,45 @@ class FontRenderer {
         GLuint VAO, VBO;
 
         /**
-         * @brief The projection matrix
+         * @brief Number of vertices the VBO currently has storage for
+         */
+        size_t vertexCapacity = 0;
+
+        /**
+         * @brief Glyph vertices queued since the last flush
+         * @details Cleared (but not deallocated) after every flush
+         */
+        std::vector<TextVertex> vertices;
+
+        /**
+         * @brief All retained text objects, indexed by handle
+         */
+        std::vector<RetainedText> retainedTexts;
+
+        /**
+         * @brief Scratch buffer used when re-laying out retained text
          */
-        glm::mat4 projection = glm::ortho(0.0f, 800.0f, 0.0f, 600.0f);
+        std::vector<TextVertex> retainedVertices;
 
         /**
-         * @brief A set of character structs mapped to their ASCII character representations
-         * @details This is the same map generated by the font class
+         * @brief The font: its glyph table and atlas texture
          */
-        std::map<char, Character> font;
+        Font font;
 
         /**
          * @brief Initializes and configures the buffer and vertex attributes
          */
         void initRenderData();
+
+        /**
+         * @brief Sets the shader uniforms that depend on the font (called once by the constructors)
+         */
+        void initShader();
+
+        /**
+         * @brief Configures the vertex attributes of the bound VAO for the bound VBO
+         */
+        void setVertexAttributes();
 };
 
 #endif // FONTRENDERER_H
@@ -0,0 +1,120 @@
+#include "glyphAtlas.h"
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_MODULE_H
+
+namespace {
+    /// @brief Width of the glyph atlas in pixels (the height grows to fit)
+    const int ATLAS_WIDTH = 512;
+
+    /// @brief Distance in pixels covered by the SDF on each side of a glyph edge
+    const int SDF_SPREAD = 4;
+}
+
+bool rasterizeGlyphAtlas(const std::string &fontPath, unsigned int fontSize, FontMode mode, GlyphAtlas &atlas) {
+    FT_Library ft;
+
+    // Initialize FreeType library
+    if (FT_Init_FreeType(&ft)) {
+        std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
+        return false;
+    }
+
+    // A small spread keeps SDF glyphs compact; it only needs to cover the smoothing width
+    if (mode == FontMode::SDF) {
+        FT_Int spread = SDF_SPREAD;
+        FT_Property_Set(ft, "sdf", "spread", &spread);
+        FT_Property_Set(ft, "bsdf", "spread", &spread);
+    }
+
+    // Load font as face
+    FT_Face face;
+    if (FT_New_Face(ft, fontPath.c_str(), 0, &face)) {
+        std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
+        FT_Done_FreeType(ft);
+        return false;
+    }
+
+    // Set size to load glyphs as
+    FT_Set_Pixel_Sizes(face, 0, fontSize);
+
+    // Pack the first 128 characters of the ASCII set into rows ("shelves") of a single atlas.
+    // Glyphs are separated by a pixel of padding so linear filtering never bleeds between them.
+    const int padding = 1;
+    std::array<glm::ivec2, GLYPH_COUNT> atlasPositions = {};
+    int penX = padding, penY = padding, rowHeight = 0;
+    atlas.glyphs = {};
+    atlas.mode = mode;
+    atlas.width = ATLAS_WIDTH;
+    atlas.height = 0;
+    atlas.pixels.clear();
+
+    for (unsigned char c = 0; c < GLYPH_COUNT; c++) {
+        // load character glyph
+        if (FT_Load_Char(face, c, mode == FontMode::SDF ? FT_LOAD_DEFAULT : FT_LOAD_RENDER)) {
+            std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
+            continue;
+        }
+        // rasterize the outline as a distance field (0.5 on the edge, larger inside).
+        // Glyphs without an outline, like space, have nothing to render but still advance.
+        if (mode == FontMode::SDF && face->glyph->outline.n_points > 0
+            && FT_Render_Glyph(face->glyph, FT_RENDER_MODE_SDF)) {
+            std::cout << "ERROR::FREETYTPE: Failed to render SDF Glyph" << std::endl;
+            continue;
+        }
+        FT_Bitmap &bitmap = face->glyph->bitmap;
+        int glyphWidth = static_cast<int>(bitmap.width);
+        int glyphHeight = static_cast<int>(bitmap.rows);
+
+        // start a new shelf when the glyph does not fit in the current one
+        if (penX + glyphWidth + padding > atlas.width) {
+            penX = padding;
+            penY += rowHeight + padding;
+            rowHeight = 0;
+        }
+        if (penY + glyphHeight + padding > atlas.height) {
+            atlas.height = penY + glyphHeight + padding;
+            atlas.pixels.resize(static_cast<size_t>(atlas.width) * atlas.height, 0);
+        }
+
+        // copy the glyph bitmap into the atlas
+        for (int row = 0; row < glyphHeight; row++) {
+            for (int col = 0; col < glyphWidth; col++) {
+                atlas.pixels[(penY + row) * atlas.width + penX + col] = bitmap.buffer[row * bitmap.pitch + col];
+            }
+        }
+        atlasPositions[c] = glm::ivec2(penX, penY);
+
+        // now store character for later use (UVs are filled in once the atlas height is known)
+        Character character = {
+            glm::vec2(0.0f),
+            glm::vec2(0.0f),
+            glm::ivec2(glyphWidth, glyphHeight),
+            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
+            static_cast<unsigned int>(face->glyph->advance.x)
+        };
+        atlas.glyphs[c] = character;
+
+        penX += glyphWidth + padding;
+        rowHeight = std::max(rowHeight, glyphHeight);
+    }
+
+    // convert atlas pixel rectangles into texture coordinates
+    for (unsigned int c = 0; c < GLYPH_COUNT; c++) {
+        Character &character = atlas.glyphs[c];
+        glm::ivec2 atlasPos = atlasPositions[c];
+        character.UVMin = glm::vec2(static_cast<float>(atlasPos.x) / atlas.width,
+                                    static_cast<float>(atlasPos.y) / atlas.height);
+        character.UVMax = glm::vec2(static_cast<float>(atlasPos.x + character.Size.x) / atlas.width,
+                                    static_cast<float>(atlasPos.y + character.Size.y) / atlas.height);
+    }
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(ft);
+    return true;
+}
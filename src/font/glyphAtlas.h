@@ -0,0 +1,43 @@
+#ifndef GRAPHICS_GLYPHATLAS_H
+#define GRAPHICS_GLYPHATLAS_H
+
+#include <string>
+#include <vector>
+
+#include "textLayout.h"
+
+/**
+ * @brief How glyphs are rasterized into the atlas
+ * @details Bitmap stores coverage and looks best at scale 1. SDF stores a signed distance field
+ * that text.frag turns back into sharp edges at any scale, so one atlas serves every text size.
+ */
+enum class FontMode { Bitmap, SDF };
+
+/**
+ * @brief A font rasterized into a single-channel atlas image on the CPU
+ * @details Produced by FreeType at startup or by the offline asset baker; uploaded by Font.
+ */
+struct GlyphAtlas {
+    /// @brief Glyph metrics and atlas texture coordinates, indexed by character code
+    GlyphTable glyphs = {};
+    /// @brief How the glyphs were rasterized
+    FontMode mode = FontMode::Bitmap;
+    /// @brief Size of the atlas image in pixels
+    int width = 0, height = 0;
+    /// @brief One byte per pixel, rows top to bottom
+    std::vector<unsigned char> pixels;
+};
+
+/**
+ * @brief Rasterizes the ASCII set of a font with FreeType and packs it into an atlas
+ * @details Makes no OpenGL calls, so it can run on any thread or in offline tools.
+ *
+ * @param fontPath The path to the font file
+ * @param fontSize The size of the font
+ * @param mode Whether glyphs are stored as coverage bitmaps or signed distance fields
+ * @param atlas The atlas to fill
+ * @return true if the font was loaded
+ */
+bool rasterizeGlyphAtlas(const std::string &fontPath, unsigned int fontSize, FontMode mode, GlyphAtlas &atlas);
+
+#endif //GRAPHICS_GLYPHATLAS_H
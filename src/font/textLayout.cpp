@@ -0,0 +1,37 @@
+#include "textLayout.h"
+
+float measureText(const GlyphTable &glyphs, std::string_view text, float scale) {
+    unsigned int advance = 0;
+    for (char c : text)
+        advance += glyphFor(glyphs, c).Advance >> 6; // bitshift by 6 to get value in pixels (2^6 = 64)
+    return advance * scale;
+}
+
+void layoutText(const GlyphTable &glyphs, std::string_view text, float x, float y, float scale,
+                glm::vec4 color, TextAlign align, std::vector<TextVertex> &out) {
+    if (align == TextAlign::Center)
+        x -= measureText(glyphs, text, scale) / 2;
+    else if (align == TextAlign::Right)
+        x -= measureText(glyphs, text, scale);
+
+    // iterate through all characters
+    for (char c : text) {
+        const Character &ch = glyphFor(glyphs, c);
+
+        float xpos = x + ch.Bearing.x * scale;
+        float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
+
+        float w = ch.Size.x * scale;
+        float h = ch.Size.y * scale;
+        // two triangles per glyph, textured from the glyph's rectangle in the atlas
+        out.push_back({{xpos,     ypos + h}, {ch.UVMin.x, ch.UVMin.y}, color});
+        out.push_back({{xpos,     ypos},     {ch.UVMin.x, ch.UVMax.y}, color});
+        out.push_back({{xpos + w, ypos},     {ch.UVMax.x, ch.UVMax.y}, color});
+
+        out.push_back({{xpos,     ypos + h}, {ch.UVMin.x, ch.UVMin.y}, color});
+        out.push_back({{xpos + w, ypos},     {ch.UVMax.x, ch.UVMax.y}, color});
+        out.push_back({{xpos + w, ypos + h}, {ch.UVMax.x, ch.UVMin.y}, color});
+        // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
+        x += (ch.Advance >> 6) * scale; // bitshift by 6 to get value in pixels (2^6 = 64)
+    }
+}
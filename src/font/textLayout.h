@@ -0,0 +1,87 @@
+#ifndef GRAPHICS_TEXTLAYOUT_H
+#define GRAPHICS_TEXTLAYOUT_H
+
+#include <array>
+#include <string_view>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/**
+ * @brief A single character
+ * @details This struct is used to store information about a single character
+ *
+ * @param UVMin Texture coordinates of the glyph's top left corner in the font atlas
+ * @param UVMax Texture coordinates of the glyph's bottom right corner in the font atlas
+ * @param Size Size of glyph
+ * @param Bearing Offset from baseline to left/top of glyph
+ * @param Advance Offset to advance to next glyph
+ */
+struct Character {
+    glm::vec2    UVMin;
+    glm::vec2    UVMax;
+    glm::ivec2   Size;
+    glm::ivec2   Bearing;
+    unsigned int Advance;
+};
+
+/**
+ * @brief Number of glyphs in a font (the ASCII set)
+ */
+const unsigned int GLYPH_COUNT = 128;
+
+/**
+ * @brief Flat table of glyphs, indexed directly by character code
+ */
+using GlyphTable = std::array<Character, GLYPH_COUNT>;
+
+/**
+ * @brief Horizontal alignment of text relative to its x position
+ */
+enum class TextAlign { Left, Center, Right };
+
+/**
+ * @brief A single glyph vertex: position, atlas texture coordinates and color
+ */
+struct TextVertex {
+    glm::vec2 pos;
+    glm::vec2 uv;
+    glm::vec4 color;
+};
+
+/**
+ * @brief Returns the glyph for a character
+ * @details Characters outside the table are drawn as '?'
+ */
+inline const Character &glyphFor(const GlyphTable &glyphs, char c) {
+    unsigned char code = static_cast<unsigned char>(c);
+    return glyphs[code < GLYPH_COUNT ? code : '?'];
+}
+
+/**
+ * @brief Measures the width of a string in pixels
+ *
+ * @param glyphs The glyph table of the font
+ * @param text The text to measure
+ * @param scale The scale of the text
+ * @return The distance the pen advances over the whole string
+ */
+float measureText(const GlyphTable &glyphs, std::string_view text, float scale);
+
+/**
+ * @brief Lays out a string and appends two triangles per glyph to a vertex array
+ * @details Does not allocate once the vertex array has enough capacity
+ *
+ * @param glyphs The glyph table of the font
+ * @param text The text to lay out
+ * @param x The x position of the text (its left, center or right edge depending on align)
+ * @param y The y position of the text baseline
+ * @param scale The scale of the text
+ * @param color The color of the text
+ * @param align How the text is aligned to x
+ * @param out The vertex array to append to
+ */
+void layoutText(const GlyphTable &glyphs, std::string_view text, float x, float y, float scale,
+                glm::vec4 color, TextAlign align, std::vector<TextVertex> &out);
+
+#endif //GRAPHICS_TEXTLAYOUT_H
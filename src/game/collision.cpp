@@ -0,0 +1,219 @@
+#include "collision.h"
+
+#include <algorithm>
+#include <cstring>
+
+// The SIMD kernels are compiled with per-function target attributes and only called after a
+// runtime CPU check, so the rest of the build needs no -msse/-mavx flags
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define GRAPHICS_COLLISION_X86
+#include <immintrin.h>
+#endif
+
+CollisionKernel Collision::kernel = Collision::detectKernel();
+
+namespace {
+    /// @brief Tests entities [first, count) one at a time, ORing their bits into mask
+    void overlapScalar(const Aabb &box, const float *x, const float *y, const float *width, const float *height,
+                       size_t first, size_t count, uint64_t *mask) {
+        for (size_t i = first; i < count; i++) {
+            float halfWidth = width[i] * 0.5f, halfHeight = height[i] * 0.5f;
+            bool hit = (x[i] - halfWidth <= box.right) & (x[i] + halfWidth >= box.left)
+                     & (y[i] - halfHeight <= box.top) & (y[i] + halfHeight >= box.bottom);
+            mask[i >> 6] |= static_cast<uint64_t>(hit) << (i & 63);
+        }
+    }
+
+#ifdef GRAPHICS_COLLISION_X86
+    /// @brief The box edges broadcast to every SSE lane
+    struct BoxSse {
+        __m128 left, right, bottom, top, half;
+    };
+
+    /// @brief Returns a 4-bit mask of which of entities [i, i + 4) overlap the box
+    __attribute__((target("sse2")))
+    inline unsigned int testSse2(const BoxSse &box, const float *x, const float *y, const float *width,
+                                 const float *height, size_t i) {
+        __m128 halfWidth = _mm_mul_ps(_mm_loadu_ps(width + i), box.half);
+        __m128 halfHeight = _mm_mul_ps(_mm_loadu_ps(height + i), box.half);
+        __m128 centerX = _mm_loadu_ps(x + i), centerY = _mm_loadu_ps(y + i);
+        __m128 hit = _mm_and_ps(_mm_cmple_ps(_mm_sub_ps(centerX, halfWidth), box.right),
+                                _mm_cmpge_ps(_mm_add_ps(centerX, halfWidth), box.left));
+        hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_sub_ps(centerY, halfHeight), box.top));
+        hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_add_ps(centerY, halfHeight), box.bottom));
+        return static_cast<unsigned int>(_mm_movemask_ps(hit));
+    }
+
+    /// @brief Tests 8 entities per iteration; returns the index the scalar code continues from
+    __attribute__((target("sse2")))
+    size_t overlapSse2(const Aabb &box, const float *x, const float *y, const float *width, const float *height,
+                       size_t count, uint64_t *mask) {
+        BoxSse edges = {_mm_set1_ps(box.left), _mm_set1_ps(box.right), _mm_set1_ps(box.bottom),
+                        _mm_set1_ps(box.top), _mm_set1_ps(0.5f)};
+        size_t i = 0;
+        // i is a multiple of 8, so a group's bits never straddle two mask words
+        for (; i + 8 <= count; i += 8) {
+            unsigned int bits = testSse2(edges, x, y, width, height, i)
+                              | testSse2(edges, x, y, width, height, i + 4) << 4;
+            mask[i >> 6] |= static_cast<uint64_t>(bits) << (i & 63);
+        }
+        return i;
+    }
+
+    /// @brief The box edges broadcast to every AVX lane
+    struct BoxAvx {
+        __m256 left, right, bottom, top, half;
+    };
+
+    /// @brief Returns an 8-bit mask of which of entities [i, i + 8) overlap the box
+    __attribute__((target("avx2")))
+    inline unsigned int testAvx2(const BoxAvx &box, const float *x, const float *y, const float *width,
+                                 const float *height, size_t i) {
+        __m256 halfWidth = _mm256_mul_ps(_mm256_loadu_ps(width + i), box.half);
+        __m256 halfHeight = _mm256_mul_ps(_mm256_loadu_ps(height + i), box.half);
+        __m256 centerX = _mm256_loadu_ps(x + i), centerY = _mm256_loadu_ps(y + i);
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(_mm256_sub_ps(centerX, halfWidth), box.right, _CMP_LE_OQ),
+                                   _mm256_cmp_ps(_mm256_add_ps(centerX, halfWidth), box.left, _CMP_GE_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_sub_ps(centerY, halfHeight), box.top, _CMP_LE_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_add_ps(centerY, halfHeight), box.bottom, _CMP_GE_OQ));
+        return static_cast<unsigned int>(_mm256_movemask_ps(hit));
+    }
+
+    /// @brief Tests 16 entities per iteration; returns the index the scalar code continues from
+    __attribute__((target("avx2")))
+    size_t overlapAvx2(const Aabb &box, const float *x, const float *y, const float *width, const float *height,
+                       size_t count, uint64_t *mask) {
+        BoxAvx edges = {_mm256_set1_ps(box.left), _mm256_set1_ps(box.right), _mm256_set1_ps(box.bottom),
+                        _mm256_set1_ps(box.top), _mm256_set1_ps(0.5f)};
+        size_t i = 0;
+        // i is a multiple of 16, so a group's bits never straddle two mask words
+        for (; i + 16 <= count; i += 16) {
+            unsigned int bits = testAvx2(edges, x, y, width, height, i)
+                              | testAvx2(edges, x, y, width, height, i + 8) << 8;
+            mask[i >> 6] |= static_cast<uint64_t>(bits) << (i & 63);
+        }
+        return i;
+    }
+#endif
+
+    /// @brief Narrows [entry, exit] to the times at which [minA, maxA], moving by d, touches [minB, maxB]
+    /// @return false if the intervals never touch within [entry, exit]
+    bool sweepAxis(float minA, float maxA, float minB, float maxB, float d, float &entry, float &exit) {
+        // without relative motion on this axis the boxes touch on it for the whole tick, or never
+        if (d == 0)
+            return minA <= maxB && maxA >= minB;
+        // moving forwards, the leading edge reaches minB first and the trailing edge leaves maxB last
+        float enter = (minB - maxA) / d, leave = (maxB - minA) / d;
+        if (d < 0)
+            std::swap(enter, leave);
+        entry = std::max(entry, enter);
+        exit = std::min(exit, leave);
+        return entry <= exit;
+    }
+
+    /// @brief Number of set bits in a mask
+    size_t countBits(const uint64_t *mask, size_t words) {
+        size_t bits = 0;
+        for (size_t word = 0; word < words; word++) {
+#if defined(__GNUC__) || defined(__clang__)
+            bits += static_cast<size_t>(__builtin_popcountll(mask[word]));
+#else
+            for (uint64_t value = mask[word]; value != 0; value &= value - 1)
+                bits++;
+#endif
+        }
+        return bits;
+    }
+}
+
+size_t Collision::maskWords(size_t count) {
+    return (count + 63) / 64;
+}
+
+size_t Collision::overlapMask(const Aabb &box, const float *x, const float *y, const float *width,
+                              const float *height, size_t count, uint64_t *mask) {
+    return overlapMask(kernel, box, x, y, width, height, count, mask);
+}
+
+size_t Collision::overlapMask(CollisionKernel kernel, const Aabb &box, const float *x, const float *y,
+                              const float *width, const float *height, size_t count, uint64_t *mask) {
+    size_t words = maskWords(count);
+    std::memset(mask, 0, words * sizeof(uint64_t));
+
+    size_t done = 0;
+#ifdef GRAPHICS_COLLISION_X86
+    if (kernel == CollisionKernel::Avx2)
+        done = overlapAvx2(box, x, y, width, height, count, mask);
+    else if (kernel == CollisionKernel::Sse2)
+        done = overlapSse2(box, x, y, width, height, count, mask);
+#endif
+    // the last few entities (all of them for the scalar kernel)
+    overlapScalar(box, x, y, width, height, done, count, mask);
+    return countBits(mask, words);
+}
+
+bool Collision::overlapsReference(const Aabb &box, float x, float y, float width, float height) {
+    float left = x - width / 2, right = x + width / 2;
+    float bottom = y - height / 2, top = y + height / 2;
+    return left <= box.right && right >= box.left && bottom <= box.top && top >= box.bottom;
+}
+
+bool Collision::sweep(const Aabb &moving, glm::vec2 motion, const Aabb &target, glm::vec2 targetMotion,
+                      float &timeOfImpact) {
+    // in the target's frame of reference only the first box moves
+    glm::vec2 relative = motion - targetMotion;
+    float entry = 0, exit = 1;
+    if (!sweepAxis(moving.left, moving.right, target.left, target.right, relative.x, entry, exit))
+        return false;
+    if (!sweepAxis(moving.bottom, moving.top, target.bottom, target.top, relative.y, entry, exit))
+        return false;
+    timeOfImpact = entry;
+    return true;
+}
+
+bool Collision::isSupported(CollisionKernel kernel) {
+    switch (kernel) {
+        case CollisionKernel::Scalar:
+            return true;
+#ifdef GRAPHICS_COLLISION_X86
+        case CollisionKernel::Sse2:
+            return __builtin_cpu_supports("sse2");
+        case CollisionKernel::Avx2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+CollisionKernel Collision::getKernel() {
+    return kernel;
+}
+
+bool Collision::setKernel(CollisionKernel kernel) {
+    if (!isSupported(kernel))
+        return false;
+    Collision::kernel = kernel;
+    return true;
+}
+
+const char *Collision::getKernelName(CollisionKernel kernel) {
+    switch (kernel) {
+        case CollisionKernel::Scalar: return "scalar";
+        case CollisionKernel::Sse2: return "sse2";
+        case CollisionKernel::Avx2: return "avx2";
+        default: return "unknown";
+    }
+}
+
+CollisionKernel Collision::detectKernel() {
+#ifdef GRAPHICS_COLLISION_X86
+    // runs during static initialization, possibly before the CPU model has been read
+    __builtin_cpu_init();
+#endif
+    if (isSupported(CollisionKernel::Avx2))
+        return CollisionKernel::Avx2;
+    if (isSupported(CollisionKernel::Sse2))
+        return CollisionKernel::Sse2;
+    return CollisionKernel::Scalar;
+}
@@ -0,0 +1,135 @@
+#ifndef GRAPHICS_COLLISION_H
+#define GRAPHICS_COLLISION_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+/**
+ * @brief An axis-aligned box given by its edges
+ */
+struct Aabb {
+    float left, right, bottom, top;
+};
+
+/**
+ * @brief Implementations of the batch overlap test
+ */
+enum class CollisionKernel { Scalar, Sse2, Avx2, Count };
+
+/**
+ * @brief Tests one box against many entity boxes at once
+ * @details Entities are given as structure-of-arrays centers and full sizes (the layout of
+ * EntityStore), and the result is a bit mask with bit i set when entity i overlaps the box.
+ * Boxes whose edges touch count as overlapping, like Shape::isOverlapping().
+ *
+ * The SIMD kernels test 8 (SSE2) or 16 (AVX2) entities per iteration and finish the last few
+ * with the scalar code. The fastest kernel the CPU supports is picked at startup; the others
+ * stay callable so they can be compared and verified against overlapsReference().
+ *
+ * sweep() is the continuous narrow phase for boxes that move during a tick.
+ */
+class Collision {
+public:
+    /// @brief Entities forEachOverlap() tests per overlapMask() call, so its mask fits on the stack
+    static constexpr size_t OVERLAP_CHUNK = 1024;
+
+    /// @brief Returns the number of 64-bit words a mask for count entities needs
+    static size_t maskWords(size_t count);
+
+    /// @brief Sets bit i of mask for every entity i that overlaps box, using the selected kernel
+    /// @param mask maskWords(count) words; they are overwritten, unused high bits are cleared
+    /// @return Number of overlapping entities
+    static size_t overlapMask(const Aabb &box, const float *x, const float *y, const float *width,
+                              const float *height, size_t count, uint64_t *mask);
+
+    /// @brief Same as above with an explicit kernel, which must be supported
+    static size_t overlapMask(CollisionKernel kernel, const Aabb &box, const float *x, const float *y,
+                              const float *width, const float *height, size_t count, uint64_t *mask);
+
+    /// @brief The overlap test for a single entity, written plainly to check the kernels against
+    static bool overlapsReference(const Aabb &box, float x, float y, float width, float height);
+
+    /// @brief Continuous test of two boxes that both move in a straight line during one tick
+    /// @details Works on the relative motion, so it does not matter which box moves. Boxes that
+    /// pass through each other within the tick are found even if they are apart at both ends.
+    /// @param moving The first box at the start of the tick
+    /// @param motion How far the first box moves during the tick
+    /// @param target The second box at the start of the tick
+    /// @param targetMotion How far the second box moves during the tick
+    /// @param timeOfImpact Set to the fraction of the tick (0 to 1) at which the boxes first touch
+    /// @return true if the boxes touch at any time during the tick
+    static bool sweep(const Aabb &moving, glm::vec2 motion, const Aabb &target, glm::vec2 targetMotion,
+                      float &timeOfImpact);
+
+    /// @brief Calls hit(i) for every set bit i of a mask, in increasing order
+    template<typename F>
+    static void forEachHit(const uint64_t *mask, size_t count, F &&hit) {
+        size_t words = maskWords(count);
+        for (size_t word = 0; word < words; word++) {
+            for (uint64_t bits = mask[word]; bits != 0; bits &= bits - 1)
+                hit(word * 64 + lowestBit(bits));
+        }
+    }
+
+    /// @brief Calls hit(i) for every entity i that overlaps box, in increasing order, stopping
+    /// early once hit() returns true
+    /// @details Runs overlapMask() over OVERLAP_CHUNK entities at a time, so any count works
+    /// without allocating a mask
+    /// @return true if hit() asked to stop
+    template<typename F>
+    static bool forEachOverlap(const Aabb &box, const float *x, const float *y, const float *width,
+                               const float *height, size_t count, F &&hit) {
+        uint64_t mask[OVERLAP_CHUNK / 64];
+        for (size_t first = 0; first < count; first += OVERLAP_CHUNK) {
+            size_t chunk = count - first < OVERLAP_CHUNK ? count - first : OVERLAP_CHUNK;
+            if (overlapMask(box, x + first, y + first, width + first, height + first, chunk, mask) == 0)
+                continue;
+            bool stop = false;
+            forEachHit(mask, chunk, [&](size_t i) {
+                if (!stop)
+                    stop = hit(first + i);
+            });
+            if (stop)
+                return true;
+        }
+        return false;
+    }
+
+    /// @brief Returns true if the CPU can run the kernel
+    static bool isSupported(CollisionKernel kernel);
+
+    /// @brief Returns the kernel overlapMask() uses
+    static CollisionKernel getKernel();
+
+    /// @brief Selects the kernel overlapMask() uses
+    /// @return false (keeping the current kernel) if the CPU does not support it
+    static bool setKernel(CollisionKernel kernel);
+
+    /// @brief Returns a kernel's name for reports ("scalar", "sse2" or "avx2")
+    static const char *getKernelName(CollisionKernel kernel);
+
+private:
+    /// @brief The kernel overlapMask() uses, the fastest supported one unless setKernel() changed it
+    static CollisionKernel kernel;
+
+    /// @brief Returns the fastest kernel the CPU supports
+    static CollisionKernel detectKernel();
+
+    /// @brief Index of the lowest set bit of a non-zero word
+    static unsigned int lowestBit(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned int>(__builtin_ctzll(bits));
+#else
+        unsigned int index = 0;
+        while (!(bits & 1)) {
+            bits >>= 1;
+            index++;
+        }
+        return index;
+#endif
+    }
+};
+
+#endif //GRAPHICS_COLLISION_H
@@ -0,0 +1,45 @@
+#include "entityStore.h"
+
+size_t EntityStore::add(vec2 pos, vec2 size, vec2 velocity, vec4 entityColor, uint8_t entityFlags) {
+    x.push_back(pos.x);
+    y.push_back(pos.y);
+    previousX.push_back(pos.x);
+    previousY.push_back(pos.y);
+    width.push_back(size.x);
+    height.push_back(size.y);
+    vx.push_back(velocity.x);
+    vy.push_back(velocity.y);
+    color.push_back(entityColor);
+    flags.push_back(entityFlags);
+    return x.size() - 1;
+}
+
+void EntityStore::reserve(size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+    previousX.reserve(count);
+    previousY.reserve(count);
+    width.reserve(count);
+    height.reserve(count);
+    vx.reserve(count);
+    vy.reserve(count);
+    color.reserve(count);
+    flags.reserve(count);
+}
+
+void EntityStore::clear() {
+    x.clear();
+    y.clear();
+    previousX.clear();
+    previousY.clear();
+    width.clear();
+    height.clear();
+    vx.clear();
+    vy.clear();
+    color.clear();
+    flags.clear();
+}
+
+size_t EntityStore::size() const {
+    return x.size();
+}
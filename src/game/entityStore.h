@@ -0,0 +1,53 @@
+#ifndef GRAPHICS_ENTITYSTORE_H
+#define GRAPHICS_ENTITYSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+using std::vector, glm::vec2, glm::vec4;
+
+/**
+ * @brief Bits of EntityStore::flags
+ */
+enum EntityFlag : uint8_t {
+    /// @brief The entity is drawn and takes part in collision (cleared when a supply is collected)
+    ENTITY_ACTIVE = 1 << 0,
+};
+
+/**
+ * @brief Structure-of-arrays storage for boxes that share a mesh
+ * @details Every attribute lives in its own contiguous array, indexed by entity, so movement and
+ * collision loops stream through exactly the fields they read. Positions are box centers and
+ * sizes are full widths and heights, like Shape. The position before the last simulation tick
+ * is kept for render interpolation.
+ *
+ * The arrays are public so hot loops can take raw pointers; use add() and clear() to keep
+ * them the same length.
+ */
+class EntityStore {
+public:
+    /// @brief Adds an entity and returns its index
+    size_t add(vec2 pos, vec2 size, vec2 velocity, vec4 color, uint8_t flags = ENTITY_ACTIVE);
+
+    /// @brief Reserves room for the given total number of entities
+    void reserve(size_t count);
+
+    /// @brief Removes every entity
+    void clear();
+
+    /// @brief Returns the number of entities
+    size_t size() const;
+
+    // Attributes, one element per entity
+    vector<float> x, y;
+    vector<float> previousX, previousY;
+    vector<float> width, height;
+    vector<float> vx, vy;
+    vector<vec4> color;
+    vector<uint8_t> flags;
+};
+
+#endif //GRAPHICS_ENTITYSTORE_H
@@ -0,0 +1,178 @@
+#include "spatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    /// @brief Marks an entity that build() left out
+    const uint32_t NO_CELL = ~0u;
+}
+
+SpatialGrid::SpatialGrid(vec2 size, float cellSize) : inverseCellSize(1.0f / cellSize) {
+    columns = std::max(1, static_cast<int>(std::ceil(size.x * inverseCellSize)));
+    rows = std::max(1, static_cast<int>(std::ceil(size.y * inverseCellSize)));
+    cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+}
+
+int SpatialGrid::columnOf(float px) const {
+    // compare as floats first, so positions far off the field (or NaN) never overflow the cast
+    float column = px * inverseCellSize;
+    if (!(column >= 0))
+        return 0;
+    if (column >= static_cast<float>(columns))
+        return columns - 1;
+    return static_cast<int>(column);
+}
+
+int SpatialGrid::rowOf(float py) const {
+    float row = py * inverseCellSize;
+    if (!(row >= 0))
+        return 0;
+    if (row >= static_cast<float>(rows))
+        return rows - 1;
+    return static_cast<int>(row);
+}
+
+void SpatialGrid::build(const EntityStore &store) {
+    size_t count = store.size();
+    size_t cells = static_cast<size_t>(columns) * rows;
+    const float *storeX = store.x.data(), *storeY = store.y.data();
+    const float *storeWidth = store.width.data(), *storeHeight = store.height.data();
+    const uint8_t *flags = store.flags.data();
+
+    // Pass 1: count the entities of each cell into cellStart[cell + 1]
+    entityCell.resize(count);
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    maxHalfWidth = 0;
+    maxHalfHeight = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!(flags[i] & ENTITY_ACTIVE)) {
+            entityCell[i] = NO_CELL;
+            continue;
+        }
+        uint32_t cell = static_cast<uint32_t>(rowOf(storeY[i]) * columns + columnOf(storeX[i]));
+        entityCell[i] = cell;
+        cellStart[cell + 1]++;
+        maxHalfWidth = std::max(maxHalfWidth, storeWidth[i] * 0.5f);
+        maxHalfHeight = std::max(maxHalfHeight, storeHeight[i] * 0.5f);
+    }
+
+    // Prefix sum: cellStart[cell] is now where the cell's entries begin
+    for (size_t cell = 1; cell <= cells; cell++)
+        cellStart[cell] += cellStart[cell - 1];
+
+    // Pass 2: scatter, using cellStart[cell] as the cell's write cursor. Afterwards every cursor
+    // has advanced to the start of the next cell, so shifting them up by one restores the starts.
+    size_t filed = cellStart[cells];
+    x.resize(filed);
+    y.resize(filed);
+    width.resize(filed);
+    height.resize(filed);
+    index.resize(filed);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t cell = entityCell[i];
+        if (cell == NO_CELL)
+            continue;
+        uint32_t entry = cellStart[cell]++;
+        x[entry] = storeX[i];
+        y[entry] = storeY[i];
+        width[entry] = storeWidth[i];
+        height[entry] = storeHeight[i];
+        index[entry] = static_cast<uint32_t>(i);
+    }
+    for (size_t cell = cells; cell > 0; cell--)
+        cellStart[cell] = cellStart[cell - 1];
+    cellStart[0] = 0;
+}
+
+void SpatialGrid::clear() {
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    x.clear();
+    y.clear();
+    width.clear();
+    height.clear();
+    index.clear();
+    maxHalfWidth = 0;
+    maxHalfHeight = 0;
+}
+
+template<typename F>
+bool SpatialGrid::testRange(const Aabb &box, uint32_t first, uint32_t last, F &&hit) const {
+    return Collision::forEachOverlap(box, x.data() + first, y.data() + first, width.data() + first,
+                                     height.data() + first, last - first, [&](size_t i) {
+        return hit(static_cast<uint32_t>(first + i));
+    });
+}
+
+template<typename F>
+bool SpatialGrid::testBox(const Aabb &box, F &&hit) const {
+    if (index.empty())
+        return false;
+    // an entity overlapping the box has its center within half its size of the box
+    int firstColumn = columnOf(box.left - maxHalfWidth), lastColumn = columnOf(box.right + maxHalfWidth);
+    int firstRow = rowOf(box.bottom - maxHalfHeight), lastRow = rowOf(box.top + maxHalfHeight);
+    for (int row = firstRow; row <= lastRow; row++) {
+        // cells are row-major, so the covered cells of a row are one contiguous range
+        size_t rowCell = static_cast<size_t>(row) * columns;
+        if (testRange(box, cellStart[rowCell + firstColumn], cellStart[rowCell + lastColumn + 1], hit))
+            return true;
+    }
+    return false;
+}
+
+void SpatialGrid::queryPoint(vec2 point, vector<uint32_t> &results) const {
+    queryBox({point.x, point.x, point.y, point.y}, results);
+}
+
+void SpatialGrid::queryBox(const Aabb &box, vector<uint32_t> &results) const {
+    testBox(box, [&](uint32_t entry) {
+        results.push_back(index[entry]);
+        return false;
+    });
+}
+
+void SpatialGrid::findPairs(vector<std::pair<uint32_t, uint32_t>> &pairs) const {
+    if (index.empty())
+        return;
+    // two overlapping entities are at most one largest size apart on each axis
+    int reachColumns = static_cast<int>(std::ceil(2 * maxHalfWidth * inverseCellSize));
+    int reachRows = static_cast<int>(std::ceil(2 * maxHalfHeight * inverseCellSize));
+
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) {
+            size_t cell = static_cast<size_t>(row) * columns + column;
+            uint32_t cellEnd = cellStart[cell + 1];
+            int lastColumn = std::min(column + reachColumns, columns - 1);
+            int firstColumn = std::max(column - reachColumns, 0);
+            int lastRow = std::min(row + reachRows, rows - 1);
+
+            for (uint32_t a = cellStart[cell]; a < cellEnd; a++) {
+                float halfWidth = width[a] * 0.5f, halfHeight = height[a] * 0.5f;
+                Aabb box = {x[a] - halfWidth, x[a] + halfWidth, y[a] - halfHeight, y[a] + halfHeight};
+                auto addPair = [&](uint32_t b) {
+                    pairs.emplace_back(std::min(index[a], index[b]), std::max(index[a], index[b]));
+                    return false;
+                };
+                // the rest of this cell and the cells to its right in this row are one range,
+                // then whole spans of the rows above; cells before this one saw the pair already
+                testRange(box, a + 1, cellStart[static_cast<size_t>(row) * columns + lastColumn + 1], addPair);
+                for (int otherRow = row + 1; otherRow <= lastRow; otherRow++) {
+                    size_t rowCell = static_cast<size_t>(otherRow) * columns;
+                    testRange(box, cellStart[rowCell + firstColumn], cellStart[rowCell + lastColumn + 1], addPair);
+                }
+            }
+        }
+    }
+}
+
+size_t SpatialGrid::size() const {
+    return index.size();
+}
+
+int SpatialGrid::getColumns() const {
+    return columns;
+}
+
+int SpatialGrid::getRows() const {
+    return rows;
+}
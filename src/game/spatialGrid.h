@@ -0,0 +1,93 @@
+#ifndef GRAPHICS_SPATIALGRID_H
+#define GRAPHICS_SPATIALGRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "collision.h"
+#include "entityStore.h"
+
+using std::vector, glm::vec2;
+
+/**
+ * @brief Uniform-grid broad phase over the boxes of one EntityStore
+ * @details The play field is divided into square cells and every active entity is filed under
+ * the cell holding its center. build() does this with a counting sort (count per cell, prefix
+ * sum, scatter), so a rebuild is two linear passes with no per-cell allocations and can run
+ * every tick. The sorted copy of the boxes is structure-of-arrays with cells in row-major
+ * order, so the cells a query covers in one grid row are a single contiguous range that is
+ * tested with Collision::overlapMask().
+ *
+ * Because entities are filed by center only, queries widen their search by the largest
+ * entity extent seen in build(). Entities outside the field are clamped into the edge cells,
+ * which keeps every query exact. Query cost grows with the number of entities near the
+ * query, not with the total.
+ */
+class SpatialGrid {
+public:
+    /// @brief Construct a grid covering [0, size.x] x [0, size.y]
+    /// @param size The size of the play field in pixels
+    /// @param cellSize Width and height of a cell; about twice the typical entity size works well
+    SpatialGrid(vec2 size, float cellSize);
+
+    /// @brief Refiles every entity of the store that has ENTITY_ACTIVE
+    /// @details Queries report indices into this store until the next build()
+    void build(const EntityStore &store);
+
+    /// @brief Removes every entity
+    void clear();
+
+    /// @brief Appends the index of every entity whose box contains the point (edges included)
+    void queryPoint(vec2 point, vector<uint32_t> &results) const;
+
+    /// @brief Appends the index of every entity whose box overlaps box (touching edges count)
+    void queryBox(const Aabb &box, vector<uint32_t> &results) const;
+
+    /// @brief Appends every pair of overlapping entities once, as (smaller index, larger index)
+    /// @details Each cell is compared with itself and with the cells after it within reach of
+    /// the largest entity, so every pair is visited from exactly one side
+    void findPairs(vector<std::pair<uint32_t, uint32_t>> &pairs) const;
+
+    /// @brief Number of entities filed by the last build()
+    size_t size() const;
+
+    int getColumns() const;
+    int getRows() const;
+
+private:
+    float inverseCellSize;
+    int columns, rows;
+
+    /// @brief Entities of cell c are entries [cellStart[c], cellStart[c + 1]) of the sorted arrays
+    vector<uint32_t> cellStart;
+
+    /// @brief Entity boxes sorted by cell, and the store index of each
+    vector<float> x, y, width, height;
+    vector<uint32_t> index;
+
+    /// @brief Cell of each store entity during build() (scratch, kept to avoid reallocating)
+    vector<uint32_t> entityCell;
+
+    /// @brief Largest half width and half height filed by the last build()
+    float maxHalfWidth = 0, maxHalfHeight = 0;
+
+    /// @brief Cell column of an x coordinate, clamped to the grid
+    int columnOf(float px) const;
+
+    /// @brief Cell row of a y coordinate, clamped to the grid
+    int rowOf(float py) const;
+
+    /// @brief Runs Collision::forEachOverlap() over sorted entries [first, last), calling
+    /// hit(entry) for each overlapping one and stopping early once hit() returns true
+    /// @return true if hit() asked to stop
+    template<typename F>
+    bool testRange(const Aabb &box, uint32_t first, uint32_t last, F &&hit) const;
+
+    /// @brief Calls testRange() for the part of each grid row that entities overlapping box can be filed in
+    template<typename F>
+    bool testBox(const Aabb &box, F &&hit) const;
+};
+
+#endif //GRAPHICS_SPATIALGRID_H
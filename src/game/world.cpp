@@ -0,0 +1,145 @@
+#include "world.h"
+#include "collision.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+    /// @brief The box of a shape moved so its center is at pos
+    Aabb boundsAt(const Shape &shape, vec2 pos) {
+        vec2 half = shape.getSize() * 0.5f;
+        return {pos.x - half.x, pos.x + half.x, pos.y - half.y, pos.y + half.y};
+    }
+
+    /// @brief The smallest box holding both boxes, grown by margin on every side
+    Aabb enclose(const Aabb &a, const Aabb &b, float margin) {
+        return {std::min(a.left, b.left) - margin, std::max(a.right, b.right) + margin,
+                std::min(a.bottom, b.bottom) - margin, std::max(a.top, b.top) + margin};
+    }
+}
+
+World::World(vec2 size) : size(size), supplyGrid(size, GRID_CELL_SIZE) {}
+
+vec2 World::randomSpawnPos() const {
+    // keep clear of the safe zone and a margin along the other edges; the engine rejects fields
+    // too small to leave any room (see parseArguments)
+    int left = static_cast<int>(SAFE_ZONE_WIDTH), right = static_cast<int>(size.x) - 15;
+    int bottom = 25, top = static_cast<int>(size.y) - 15;
+    int xSpot = left + rand() % (right - left);
+    int ySpot = bottom + rand() % (top - bottom);
+    return vec2{xSpot, ySpot};
+}
+
+void World::spawn(int supplyCount, int enemyCount, float speed) {
+    this->speed = speed;
+    supplies.reserve(supplies.size() + supplyCount);
+    enemies.reserve(enemies.size() + enemyCount);
+
+    for (int i = 0; i < supplyCount; i++)
+        supplies.add(randomSpawnPos(), supplySize, vec2(0), purple.vec);
+    // Even enemies move left and right, odd ones up and down, all starting right/up
+    float enemySpeed = ENEMY_SPEED * speed;
+    for (int i = 0; i < enemyCount; i++) {
+        vec2 velocity = enemies.size() % 2 == 0 ? vec2(enemySpeed, 0) : vec2(0, enemySpeed);
+        enemies.add(randomSpawnPos(), enemySize, velocity, red.vec);
+    }
+    supplyGrid.build(supplies);
+}
+
+void World::clear() {
+    supplies.clear();
+    enemies.clear();
+    supplyGrid.clear();
+    enemyStep = 0;
+}
+
+void World::moveEnemies(float dt) {
+    size_t count = enemies.size();
+    float *x = enemies.x.data(), *y = enemies.y.data();
+    float *previousX = enemies.previousX.data(), *previousY = enemies.previousY.data();
+    float *vx = enemies.vx.data(), *vy = enemies.vy.data();
+    float right = size.x - 10, top = size.y - 20;
+    float left = SAFE_ZONE_WIDTH, bottom = 20;
+    // every enemy moves at the same speed along one axis
+    enemyStep = ENEMY_SPEED * speed * dt;
+
+    // One branch-free pass: integrate, then reverse the velocity of anything past an edge while
+    // still heading outwards. An enemy at rest on an axis keeps a zero velocity on it.
+    // The tests use & and | rather than && and || so the loop body has no branches (and can be
+    // vectorized at -O3).
+    for (size_t i = 0; i < count; i++) {
+        previousX[i] = x[i];
+        previousY[i] = y[i];
+        float newX = x[i] + vx[i] * dt;
+        float newY = y[i] + vy[i] * dt;
+        bool flipX = ((vx[i] > 0) & (newX > right)) | ((vx[i] < 0) & (newX < left));
+        bool flipY = ((vy[i] > 0) & (newY > top)) | ((vy[i] < 0) & (newY < bottom));
+        x[i] = newX;
+        y[i] = newY;
+        vx[i] = flipX ? -vx[i] : vx[i];
+        vy[i] = flipY ? -vy[i] : vy[i];
+    }
+}
+
+int World::collectSupplies(const Shape &player, vec2 previousPos) {
+    // Supplies stand still, so any supply the player touched during the tick lies in the box
+    // spanning its start and end positions; the sweep then drops the corners it never crossed
+    Aabb start = boundsAt(player, previousPos);
+    vec2 motion = player.getPos() - previousPos;
+    nearby.clear();
+    supplyGrid.queryBox(enclose(start, boundsAt(player, player.getPos()), 0), nearby);
+
+    // Supplies never move, so their grid is only built on spawn; collected supplies stay filed
+    // there and are skipped here rather than paying for a rebuild on every pickup
+    int collected = 0;
+    for (uint32_t i : nearby) {
+        if (!(supplies.flags[i] & ENTITY_ACTIVE))
+            continue;
+        float halfWidth = supplies.width[i] * 0.5f, halfHeight = supplies.height[i] * 0.5f;
+        Aabb supply = {supplies.x[i] - halfWidth, supplies.x[i] + halfWidth,
+                       supplies.y[i] - halfHeight, supplies.y[i] + halfHeight};
+        float timeOfImpact;
+        if (Collision::sweep(start, motion, supply, vec2(0), timeOfImpact)) {
+            supplies.flags[i] &= ~ENTITY_ACTIVE;
+            collected++;
+        }
+    }
+    return collected;
+}
+
+void World::restoreSupplies() {
+    for (uint8_t &flags : supplies.flags)
+        flags |= ENTITY_ACTIVE;
+}
+
+bool World::hitsEnemy(const Shape &player, vec2 previousPos) const {
+    // Broad phase: an enemy that touched the player during the tick ends it within one step of
+    // the box the player swept. One box against every enemy is a linear SIMD scan, cheaper than
+    // filing every moved enemy in a grid each tick just to answer a single query.
+    Aabb start = boundsAt(player, previousPos);
+    vec2 motion = player.getPos() - previousPos;
+    Aabb reach = enclose(start, boundsAt(player, player.getPos()), enemyStep);
+
+    // Narrow phase: sweep the player against each candidate from their positions before the tick
+    return Collision::forEachOverlap(reach, enemies.x.data(), enemies.y.data(), enemies.width.data(),
+                                     enemies.height.data(), enemies.size(), [&](size_t i) {
+        float halfWidth = enemies.width[i] * 0.5f, halfHeight = enemies.height[i] * 0.5f;
+        Aabb enemy = {enemies.previousX[i] - halfWidth, enemies.previousX[i] + halfWidth,
+                      enemies.previousY[i] - halfHeight, enemies.previousY[i] + halfHeight};
+        vec2 enemyMotion = {enemies.x[i] - enemies.previousX[i], enemies.y[i] - enemies.previousY[i]};
+        float timeOfImpact;
+        return Collision::sweep(start, motion, enemy, enemyMotion, timeOfImpact);
+    });
+}
+
+const EntityStore &World::getSupplies() const {
+    return supplies;
+}
+
+const EntityStore &World::getEnemies() const {
+    return enemies;
+}
+
+vec2 World::getSize() const {
+    return size;
+}
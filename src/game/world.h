@@ -0,0 +1,103 @@
+#ifndef GRAPHICS_WORLD_H
+#define GRAPHICS_WORLD_H
+
+#include <memory>
+#include <vector>
+
+#include "entityStore.h"
+#include "spatialGrid.h"
+#include "../shapes/shape.h"
+#include "../util/color.h"
+
+using std::vector, glm::vec2;
+
+/**
+ * @brief The simulated play field: supplies, enemies, their movement, spawning and collision
+ * @details Makes no OpenGL calls, so the game rules can run and be benchmarked without a context.
+ * Supplies and enemies are kept in structure-of-arrays stores so the per-tick loops stream
+ * linearly over plain float arrays. Supplies never move, so a SpatialGrid built on spawn answers
+ * the player's pickups; enemies move every tick, so the player is tested against all of them
+ * with one SIMD scan instead. The engine owns one World and draws its stores.
+ */
+class World {
+public:
+    /// @brief Width of the safe zone on the left edge, where nothing spawns or moves
+    static constexpr float SAFE_ZONE_WIDTH = 80;
+
+    /// @brief Enemy speed in pixels per second at a speed modifier of 1
+    static constexpr float ENEMY_SPEED = 120;
+
+    /// @brief Cell size of the collision grid, about twice the size of an enemy
+    static constexpr float GRID_CELL_SIZE = 32;
+
+    /// @brief Construct an empty world
+    /// @param size The size of the play field in pixels
+    explicit World(vec2 size);
+
+    /// @brief Spawns supplies and enemies at random positions outside the safe zone
+    /// @param supplyCount Number of supplies to add
+    /// @param enemyCount Number of enemies to add
+    /// @param speed Enemy speed modifier (a multiple of ENEMY_SPEED)
+    void spawn(int supplyCount, int enemyCount, float speed);
+
+    /// @brief Removes every supply and enemy
+    void clear();
+
+    /// @brief Advances every enemy one simulation tick
+    /// @details Even enemies move horizontally and odd ones vertically, bouncing off the safe zone and the edges.
+    /// Each enemy's position before the tick is kept for interpolation.
+    /// @param dt Length of the tick in seconds
+    void moveEnemies(float dt);
+
+    /// @brief Collects every supply the player touched during the last tick
+    /// @details The player is swept from previousPos to its position, so fast moves and low tick
+    /// rates cannot skip over a supply. Collected supplies lose ENTITY_ACTIVE and are skipped from then on.
+    /// @param player The player's shape
+    /// @param previousPos The player's position before the tick
+    /// @return Number of supplies collected by this call
+    int collectSupplies(const Shape &player, vec2 previousPos);
+
+    /// @brief Makes every collected supply collectable again
+    /// @details The supply grid still holds every supply of the last spawn, so nothing is rebuilt
+    void restoreSupplies();
+
+    /// @brief Returns true if the player touched any enemy during the last tick
+    /// @details Both are swept over the tick (the player from previousPos, enemies from their
+    /// previous positions), so they cannot pass through each other between ticks.
+    /// @param player The player's shape
+    /// @param previousPos The player's position before the tick
+    bool hitsEnemy(const Shape &player, vec2 previousPos) const;
+
+    const EntityStore &getSupplies() const;
+    const EntityStore &getEnemies() const;
+    vec2 getSize() const;
+
+private:
+    vec2 size;
+
+    EntityStore supplies;
+    EntityStore enemies;
+
+    /// @brief Broad phase over the active supplies
+    SpatialGrid supplyGrid;
+
+    /// @brief Scratch list of query results (kept to avoid reallocating every tick)
+    vector<uint32_t> nearby;
+
+    /// @brief Enemy speed modifier for the current session
+    float speed = 0;
+
+    /// @brief How far an enemy moved on the last moveEnemies(), which widens the hitsEnemy() broad phase
+    float enemyStep = 0;
+
+    // Attributes of the spawned shapes
+    vec2 supplySize = {10, 10};
+    vec2 enemySize = {15, 15};
+    color purple = {1, 0, 1, 1.0f};
+    color red = {1, 0, 0, 1.0f};
+
+    /// @brief Returns a random spawn position outside the safe zone
+    vec2 randomSpawnPos() const;
+};
+
+#endif //GRAPHICS_WORLD_H
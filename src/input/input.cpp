@@ -0,0 +1,108 @@
+#include "input.h"
+
+Input::Input() {
+    for (int action = 0; action < static_cast<int>(Action::Count); action++)
+        unbind(static_cast<Action>(action));
+    bindDefaults();
+}
+
+void Input::beginFrame() {
+    pressed.reset();
+    released.reset();
+    hasPressTime = false;
+}
+
+void Input::onKey(int key, int action) {
+    // GLFW_KEY_UNKNOWN (-1) is sent for keys without a key code
+    if (key < 0 || key >= KEY_COUNT)
+        return;
+    if (action == GLFW_PRESS && !down[key]) {
+        if (!hasPressTime) {
+            firstPressTime = Clock::now();
+            hasPressTime = true;
+        }
+        down.set(key);
+        pressed.set(key);
+    } else if (action == GLFW_RELEASE) {
+        down.reset(key);
+        released.set(key);
+    }
+}
+
+void Input::onCursor(double x, double y) {
+    cursorX = x;
+    cursorY = y;
+}
+
+bool Input::isDown(int key) const {
+    return key >= 0 && key < KEY_COUNT && down[key];
+}
+
+bool Input::anyBound(const std::bitset<KEY_COUNT> &keys, Action action) const {
+    for (int key : bindings[static_cast<int>(action)]) {
+        if (key != GLFW_KEY_UNKNOWN && keys[key])
+            return true;
+    }
+    return false;
+}
+
+bool Input::isDown(Action action) const {
+    return anyBound(down, action);
+}
+
+bool Input::wasPressed(Action action) const {
+    return anyBound(pressed, action);
+}
+
+bool Input::wasReleased(Action action) const {
+    return anyBound(released, action);
+}
+
+bool Input::getFirstPressTime(Clock::time_point &time) const {
+    time = firstPressTime;
+    return hasPressTime;
+}
+
+void Input::getCursorPos(double &x, double &y) const {
+    x = cursorX;
+    y = cursorY;
+}
+
+void Input::bind(Action action, int key) {
+    if (key < 0 || key >= KEY_COUNT)
+        return;
+    for (int &slot : bindings[static_cast<int>(action)]) {
+        if (slot == GLFW_KEY_UNKNOWN) {
+            slot = key;
+            return;
+        }
+    }
+}
+
+void Input::unbind(Action action) {
+    for (int &slot : bindings[static_cast<int>(action)])
+        slot = GLFW_KEY_UNKNOWN;
+}
+
+void Input::bindDefaults() {
+    // W/A/S/D share keys with the menus, but menus and movement are never active on the same screen
+    bind(Action::MoveUp, GLFW_KEY_UP);
+    bind(Action::MoveUp, GLFW_KEY_W);
+    bind(Action::MoveDown, GLFW_KEY_DOWN);
+    bind(Action::MoveDown, GLFW_KEY_S);
+    bind(Action::MoveLeft, GLFW_KEY_LEFT);
+    bind(Action::MoveLeft, GLFW_KEY_A);
+    bind(Action::MoveRight, GLFW_KEY_RIGHT);
+    bind(Action::MoveRight, GLFW_KEY_D);
+
+    bind(Action::Continue, GLFW_KEY_C);
+    bind(Action::Start, GLFW_KEY_S);
+    bind(Action::Easy, GLFW_KEY_E);
+    bind(Action::Medium, GLFW_KEY_M);
+    bind(Action::Hard, GLFW_KEY_H);
+    bind(Action::Death, GLFW_KEY_D);
+    bind(Action::Restart, GLFW_KEY_R);
+
+    bind(Action::ToggleProfiler, GLFW_KEY_F3);
+    bind(Action::Quit, GLFW_KEY_ESCAPE);
+}
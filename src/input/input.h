@@ -0,0 +1,99 @@
+#ifndef GRAPHICS_INPUT_H
+#define GRAPHICS_INPUT_H
+
+#include <bitset>
+#include <chrono>
+#include <GLFW/glfw3.h>
+
+/**
+ * @brief Game actions that keys are bound to
+ */
+enum class Action {
+    MoveUp, MoveDown, MoveLeft, MoveRight,
+    Continue, Start, Easy, Medium, Hard, Death, Restart,
+    ToggleProfiler, Quit,
+    Count
+};
+
+/**
+ * @brief Keyboard and cursor state, filled by the platform's input callbacks
+ * @details The window context forwards every key and cursor event to onKey() and onCursor(),
+ * so the per-frame cost is one bitset clear plus the work for the events that actually
+ * arrived, rather than a query for every key on the keyboard. Edges (pressed / released this
+ * frame) are accumulated from the events themselves, so a tap that starts and ends within one
+ * frame is still seen as pressed.
+ *
+ * Keys are bound to actions (up to MAX_BINDINGS keys per action); gameplay code asks about
+ * actions and never about raw key codes.
+ */
+class Input {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Number of key codes tracked (every GLFW_KEY_* value)
+    static const int KEY_COUNT = GLFW_KEY_LAST + 1;
+
+    /// @brief Maximum number of keys bound to one action
+    static const int MAX_BINDINGS = 4;
+
+    /// @brief Construct an input with the default bindings (see bindDefaults())
+    Input();
+
+    /// @brief Clears the pressed and released edges of the previous frame
+    /// @details Call once per frame, right before the platform delivers new events
+    void beginFrame();
+
+    /// @brief Records a key event (GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT)
+    void onKey(int key, int action);
+
+    /// @brief Records the cursor position
+    void onCursor(double x, double y);
+
+    /// @brief Returns true while the key is held
+    bool isDown(int key) const;
+
+    /// @brief Returns true if any key bound to the action is held
+    bool isDown(Action action) const;
+
+    /// @brief Returns true if a key bound to the action went down this frame
+    bool wasPressed(Action action) const;
+
+    /// @brief Returns true if a key bound to the action went up this frame
+    bool wasReleased(Action action) const;
+
+    /// @brief Returns when the first key press of this frame was delivered
+    /// @return false if no key was pressed this frame
+    bool getFirstPressTime(Clock::time_point &time) const;
+
+    /// @brief Returns the last cursor position in window coordinates
+    void getCursorPos(double &x, double &y) const;
+
+    /// @brief Binds a key to an action, in addition to the keys already bound to it
+    /// @details Ignored once the action has MAX_BINDINGS keys
+    void bind(Action action, int key);
+
+    /// @brief Removes every key bound to the action
+    void unbind(Action action);
+
+    /// @brief Binds arrow keys and WASD for movement, and the menu keys of the game
+    void bindDefaults();
+
+private:
+    std::bitset<KEY_COUNT> down;
+    std::bitset<KEY_COUNT> pressed;
+    std::bitset<KEY_COUNT> released;
+
+    double cursorX = 0, cursorY = 0;
+
+    /// @brief Delivery time of the first press since beginFrame(), for latency tracing
+    Clock::time_point firstPressTime;
+    bool hasPressTime = false;
+
+    /// @brief Keys bound to each action; unused slots hold GLFW_KEY_UNKNOWN
+    int bindings[static_cast<int>(Action::Count)][MAX_BINDINGS];
+
+    /// @brief Returns true if any key bound to the action is set in the given bitset
+    bool anyBound(const std::bitset<KEY_COUNT> &keys, Action action) const;
+};
+
+#endif //GRAPHICS_INPUT_H
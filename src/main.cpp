@@ -1,18 +1,22 @@
-
 #include "engine.h"
+#include "util/profiler.h"
 
 #include <iostream>
 
 
 int main(int argc, char *argv[]) {
-    Engine engine;
+    EngineConfig config;
+    if (!parseArguments(argc, argv, config))
+        return 1;
+
+    // The engine owns the window (or headless context) and tears it down after its GL objects
+    Engine engine(config);
 
     while (!engine.shouldClose()) {
+        PROFILE_FRAME();
         engine.processInput();
         engine.update();
         engine.render();
     }
-
-    glfwTerminate();
     return 0;
 }
@@ -0,0 +1,96 @@
+#include "framePacer.h"
+
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+FramePacer::FramePacer(PacingMode mode, double targetFps) : mode(mode), targetFps(targetFps) {
+    period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps));
+}
+
+int FramePacer::getSwapInterval() const {
+    return mode == PacingMode::Vsync ? 1 : 0;
+}
+
+void FramePacer::wait() {
+    if (mode != PacingMode::Limited)
+        return;
+
+    Clock::time_point now = Clock::now();
+    if (!hasDeadline) {
+        deadline = now + period;
+        hasDeadline = true;
+    }
+    // After a frame that overran by more than a whole period, restart the schedule from now
+    // instead of presenting a burst of frames to catch up
+    if (now > deadline + period)
+        deadline = now;
+    waitUntil(deadline);
+    // deadlines advance by exactly one period, so rounding never accumulates into drift
+    deadline += period;
+}
+
+void FramePacer::waitUntil(Clock::time_point time) {
+    using seconds = std::chrono::duration<double>;
+    while (true) {
+        Clock::time_point start = Clock::now();
+        double estimate = sleepMean + (sleepCount > 1 ? std::sqrt(sleepM2 / (sleepCount - 1)) : 0);
+        if (seconds(time - start).count() <= estimate)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        // learn how long a 1 ms sleep really takes on this system
+        double observed = seconds(Clock::now() - start).count();
+        sleepCount++;
+        double delta = observed - sleepMean;
+        sleepMean += delta / sleepCount;
+        sleepM2 += delta * (observed - sleepMean);
+    }
+    // less than one sleep's worth is left: spin on the clock
+    while (Clock::now() < time)
+        std::this_thread::yield();
+}
+
+void FramePacer::endFrame() {
+    Clock::time_point now = Clock::now();
+    if (hasLastPresent) {
+        double interval = std::chrono::duration<double, std::milli>(now - lastPresent).count();
+        frames++;
+        double delta = interval - intervalMean;
+        intervalMean += delta / frames;
+        intervalM2 += delta * (interval - intervalMean);
+        intervalMin = frames == 1 ? interval : std::fmin(intervalMin, interval);
+        intervalMax = frames == 1 ? interval : std::fmax(intervalMax, interval);
+        // a frame is late when it took at least half a period longer than the target
+        if (mode == PacingMode::Limited && interval > 1500.0 / targetFps)
+            lateFrames++;
+    }
+    lastPresent = now;
+    hasLastPresent = true;
+}
+
+std::string FramePacer::getModeName() const {
+    switch (mode) {
+        case PacingMode::Uncapped:
+            return "uncapped";
+        case PacingMode::Vsync:
+            return "vsync";
+        case PacingMode::Limited: {
+            char name[32];
+            std::snprintf(name, sizeof(name), "fps:%g", targetFps);
+            return name;
+        }
+    }
+    return "";
+}
+
+void FramePacer::printReport() const {
+    if (frames == 0)
+        return;
+    double deviation = frames > 1 ? std::sqrt(intervalM2 / (frames - 1)) : 0;
+    std::printf("Frame pacing (%s): %lu frames, interval mean %.3f ms, stddev %.3f ms, min %.3f ms, max %.3f ms",
+                getModeName().c_str(), frames, intervalMean, deviation, intervalMin, intervalMax);
+    if (mode == PacingMode::Limited)
+        std::printf(", %lu late", lateFrames);
+    std::printf("\n");
+}
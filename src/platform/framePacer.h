@@ -0,0 +1,78 @@
+#ifndef GRAPHICS_FRAMEPACER_H
+#define GRAPHICS_FRAMEPACER_H
+
+#include <chrono>
+#include <string>
+
+/**
+ * @brief How frames are paced
+ * @details Uncapped presents as fast as possible (swap interval 0), Vsync waits for the display
+ * on every swap, and Limited holds a target frame rate with FramePacer::wait() instead.
+ */
+enum class PacingMode { Uncapped, Vsync, Limited };
+
+/**
+ * @brief Paces frames to a mode and measures how evenly frames were presented
+ * @details The limiter waits for deadlines spaced exactly one period apart on a monotonic clock.
+ * It sleeps in short slices while the remaining time exceeds its estimate of how far a sleep
+ * overshoots, then spins for the last fraction of a millisecond. That keeps jitter well below a
+ * millisecond while leaving the core idle for most of the frame. The overshoot estimate
+ * (mean plus one standard deviation of past sleeps) adapts to the OS timer resolution.
+ */
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Construct a pacer
+    /// @param mode The pacing mode
+    /// @param targetFps Frame rate held in Limited mode (ignored otherwise)
+    FramePacer(PacingMode mode, double targetFps);
+
+    /// @brief Returns the swap interval the context should use for this mode
+    int getSwapInterval() const;
+
+    /// @brief Waits for the next frame deadline in Limited mode; returns at once otherwise
+    /// @details Call right before presenting the frame
+    void wait();
+
+    /// @brief Records the time since the previous frame was presented
+    /// @details Call right after presenting the frame
+    void endFrame();
+
+    /// @brief Returns the mode as given on the command line ("uncapped", "vsync" or "fps:N")
+    std::string getModeName() const;
+
+    /// @brief Prints the frame interval mean, standard deviation, range and late frames
+    void printReport() const;
+
+private:
+    PacingMode mode;
+    double targetFps;
+
+    /// @brief Length of a frame in Limited mode
+    Clock::duration period;
+
+    /// @brief When the next frame is due in Limited mode (unset until the first wait())
+    Clock::time_point deadline;
+    bool hasDeadline = false;
+
+    /// @brief Running mean and variance (Welford) of how long a 1 ms sleep really takes, in seconds
+    double sleepMean = 0.002;
+    double sleepM2 = 0;
+    unsigned long sleepCount = 0;
+
+    /// @brief Running statistics of the presented frame intervals, in milliseconds
+    Clock::time_point lastPresent;
+    bool hasLastPresent = false;
+    unsigned long frames = 0;
+    double intervalMean = 0;
+    double intervalM2 = 0;
+    double intervalMin = 0;
+    double intervalMax = 0;
+    unsigned long lateFrames = 0;
+
+    /// @brief Sleeps then spins until the given time
+    void waitUntil(Clock::time_point time);
+};
+
+#endif //GRAPHICS_FRAMEPACER_H
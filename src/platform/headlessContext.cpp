@@ -0,0 +1,191 @@
+#include "headlessContext.h"
+
+#include <cstring>
+#include <iostream>
+
+#ifdef GRAPHICS_HAS_EGL
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#ifdef GRAPHICS_HAS_OSMESA
+#include <GL/osmesa.h>
+#endif
+
+HeadlessContext::~HeadlessContext() {
+    if (framebuffer != 0) {
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(1, &colorBuffer);
+    }
+#ifdef GRAPHICS_HAS_EGL
+    if (eglDisplay != nullptr) {
+        eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (eglSurface != nullptr)
+            eglDestroySurface(eglDisplay, eglSurface);
+        if (eglContext != nullptr)
+            eglDestroyContext(eglDisplay, eglContext);
+        eglTerminate(eglDisplay);
+    }
+#endif
+#ifdef GRAPHICS_HAS_OSMESA
+    if (osMesaContext != nullptr)
+        OSMesaDestroyContext(static_cast<OSMesaContext>(osMesaContext));
+#endif
+}
+
+bool HeadlessContext::create(unsigned int width, unsigned int height, const char * /*title*/) {
+    startTime = std::chrono::steady_clock::now();
+
+    if (!createEGL(width, height) && !createOSMesa(width, height)) {
+        std::cout << "ERROR::CONTEXT: Failed to create a headless OpenGL context (no usable EGL or OSMesa)" << std::endl;
+        return false;
+    }
+    return createFramebuffer(width, height);
+}
+
+bool HeadlessContext::createEGL(unsigned int width, unsigned int height) {
+#ifdef GRAPHICS_HAS_EGL
+    // The surfaceless platform needs neither a display server nor a GPU device
+    EGLDisplay display = EGL_NO_DISPLAY;
+    const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (clientExtensions != nullptr && std::strstr(clientExtensions, "EGL_MESA_platform_surfaceless") && getPlatformDisplay != nullptr)
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display == EGL_NO_DISPLAY)
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+        return false;
+    eglDisplay = display;
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+        return false;
+
+    // Prefer a config with pbuffer support, but accept any desktop GL config for surfaceless use
+    const EGLint pbufferConfig[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    const EGLint anyConfig[] = {
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    bool pbuffer = eglChooseConfig(display, pbufferConfig, &config, 1, &configCount) && configCount > 0;
+    if (!pbuffer && !(eglChooseConfig(display, anyConfig, &config, 1, &configCount) && configCount > 0))
+        return false;
+
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (context == EGL_NO_CONTEXT)
+        return false;
+    eglContext = context;
+
+    // The pbuffer is only there to satisfy drivers without EGL_KHR_surfaceless_context;
+    // everything is drawn into our own framebuffer object
+    EGLSurface surface = EGL_NO_SURFACE;
+    if (pbuffer) {
+        const EGLint surfaceAttributes[] = {EGL_WIDTH, static_cast<EGLint>(width), EGL_HEIGHT, static_cast<EGLint>(height), EGL_NONE};
+        surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+        if (surface != EGL_NO_SURFACE)
+            eglSurface = surface;
+    }
+    if (!eglMakeCurrent(display, surface, surface, context))
+        return false;
+
+    if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return false;
+    }
+    std::cout << "Headless context: EGL " << (surface != EGL_NO_SURFACE ? "pbuffer" : "surfaceless")
+              << ", " << glGetString(GL_RENDERER) << std::endl;
+    return true;
+#else
+    (void)width;
+    (void)height;
+    return false;
+#endif
+}
+
+bool HeadlessContext::createOSMesa(unsigned int width, unsigned int height) {
+#ifdef GRAPHICS_HAS_OSMESA
+    const int attributes[] = {
+        OSMESA_FORMAT, OSMESA_RGBA,
+        OSMESA_DEPTH_BITS, 0,
+        OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+        OSMESA_CONTEXT_MAJOR_VERSION, 3,
+        OSMESA_CONTEXT_MINOR_VERSION, 3,
+        0
+    };
+    OSMesaContext context = OSMesaCreateContextAttribs(attributes, nullptr);
+    if (context == nullptr)
+        return false;
+    osMesaContext = context;
+
+    osMesaBuffer.resize(static_cast<size_t>(width) * height * 4);
+    if (!OSMesaMakeCurrent(context, osMesaBuffer.data(), GL_UNSIGNED_BYTE, width, height))
+        return false;
+
+    if (!gladLoadGLLoader((GLADloadproc)OSMesaGetProcAddress)) {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return false;
+    }
+    std::cout << "Headless context: OSMesa, " << glGetString(GL_RENDERER) << std::endl;
+    return true;
+#else
+    (void)width;
+    (void)height;
+    return false;
+#endif
+}
+
+bool HeadlessContext::createFramebuffer(unsigned int width, unsigned int height) {
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    // Left bound for the lifetime of the context, so it acts as the default framebuffer
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "ERROR::CONTEXT: Headless framebuffer is incomplete" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void HeadlessContext::pollEvents() {}
+
+void HeadlessContext::setInput(Input * /*input*/) {
+    // there is no keyboard or cursor without a window, so no events are ever delivered
+}
+
+bool HeadlessContext::shouldClose() const {
+    return closeRequested;
+}
+
+void HeadlessContext::setShouldClose(bool close) {
+    closeRequested = close;
+}
+
+void HeadlessContext::swapBuffers() {
+    // Nothing is presented; wait for the frame so work cannot pile up across frames
+    glFinish();
+}
+
+void HeadlessContext::setSwapInterval(int /*interval*/) {
+    // nothing is presented, so there is no display to sync to; parseArguments() turns vsync into uncapped
+}
+
+double HeadlessContext::getTime() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
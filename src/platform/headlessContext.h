@@ -0,0 +1,62 @@
+#ifndef GRAPHICS_HEADLESSCONTEXT_H
+#define GRAPHICS_HEADLESSCONTEXT_H
+
+#include "platformContext.h"
+
+#include <chrono>
+#include <vector>
+#include <glad/glad.h>
+
+/**
+ * @brief An offscreen OpenGL context for machines without a display or GPU
+ * @details Tries EGL first (surfaceless platform, then the default display with a pbuffer), which
+ * Mesa's llvmpipe provides on plain Linux machines, and falls back to OSMesa. Either way the frame
+ * is rendered into a framebuffer object of the requested size that stays bound as the default
+ * target, so the engine draws exactly as it does into a window. There is no input: no key is
+ * ever down, and the context only closes when asked to.
+ * @note EGL and OSMesa support are compiled in when CMake finds them (GRAPHICS_HAS_EGL,
+ * GRAPHICS_HAS_OSMESA).
+ */
+class HeadlessContext : public PlatformContext {
+public:
+    HeadlessContext() = default;
+
+    /// @brief Deletes the framebuffer and destroys the context
+    ~HeadlessContext() override;
+
+    bool create(unsigned int width, unsigned int height, const char *title) override;
+    void pollEvents() override;
+    void setInput(Input *input) override;
+    bool shouldClose() const override;
+    void setShouldClose(bool close) override;
+    void swapBuffers() override;
+    void setSwapInterval(int interval) override;
+    double getTime() const override;
+
+private:
+    /// @brief Time origin; taken from a steady clock since there is no GLFW timer
+    std::chrono::steady_clock::time_point startTime;
+
+    bool closeRequested = false;
+
+    /// @brief The offscreen render target
+    GLuint framebuffer = 0, colorBuffer = 0;
+
+    /// @brief EGL objects (void* so this header does not pull in EGL)
+    void *eglDisplay = nullptr, *eglContext = nullptr, *eglSurface = nullptr;
+
+    /// @brief OSMesa context and the client memory it renders into
+    void *osMesaContext = nullptr;
+    std::vector<unsigned char> osMesaBuffer;
+
+    /// @brief Creates an EGL context; returns false if EGL is unavailable
+    bool createEGL(unsigned int width, unsigned int height);
+
+    /// @brief Creates an OSMesa context; returns false if OSMesa is unavailable
+    bool createOSMesa(unsigned int width, unsigned int height);
+
+    /// @brief Creates and binds the framebuffer object the engine renders into
+    bool createFramebuffer(unsigned int width, unsigned int height);
+};
+
+#endif //GRAPHICS_HEADLESSCONTEXT_H
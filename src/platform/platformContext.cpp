@@ -0,0 +1,9 @@
+#include "platformContext.h"
+#include "windowContext.h"
+#include "headlessContext.h"
+
+std::unique_ptr<PlatformContext> makePlatformContext(bool headless) {
+    if (headless)
+        return std::make_unique<HeadlessContext>();
+    return std::make_unique<WindowContext>();
+}
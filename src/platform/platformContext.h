@@ -0,0 +1,56 @@
+#ifndef GRAPHICS_PLATFORMCONTEXT_H
+#define GRAPHICS_PLATFORMCONTEXT_H
+
+#include <memory>
+
+class Input;
+
+/**
+ * @brief An OpenGL 3.3 core context plus the input and timing the engine needs from the platform
+ * @details Implemented by WindowContext (a visible GLFW window) and HeadlessContext (an offscreen
+ * EGL or OSMesa context rendering into a framebuffer object). The engine only talks to this
+ * interface, so it behaves the same with or without a display.
+ */
+class PlatformContext {
+public:
+    virtual ~PlatformContext() = default;
+
+    /// @brief Creates the context, makes it current and loads the GL function pointers
+    /// @param width The framebuffer width in pixels
+    /// @param height The framebuffer height in pixels
+    /// @param title The window title (ignored when headless)
+    /// @return true if a context is current
+    virtual bool create(unsigned int width, unsigned int height, const char *title) = 0;
+
+    /// @brief Processes pending window events
+    /// @details Key and cursor events are delivered to the Input given to setInput()
+    virtual void pollEvents() = 0;
+
+    /// @brief Sets where key and cursor events are delivered
+    /// @param input The input to update; must outlive the context's event processing
+    virtual void setInput(Input *input) = 0;
+
+    /// @brief Returns true once the window was asked to close
+    virtual bool shouldClose() const = 0;
+
+    /// @brief Asks the window to close
+    virtual void setShouldClose(bool close) = 0;
+
+    /// @brief Presents the finished frame
+    virtual void swapBuffers() = 0;
+
+    /// @brief Sets how many vertical blanks to wait for on each swap (0 disables vsync)
+    virtual void setSwapInterval(int interval) = 0;
+
+    /// @brief Returns the number of seconds since the context was created
+    virtual double getTime() const = 0;
+};
+
+/**
+ * @brief Creates the platform context
+ * @param headless true for an offscreen context that needs no display
+ * @return The context (not yet created; call create())
+ */
+std::unique_ptr<PlatformContext> makePlatformContext(bool headless);
+
+#endif //GRAPHICS_PLATFORMCONTEXT_H
@@ -0,0 +1,78 @@
+#include "windowContext.h"
+#include "../input/input.h"
+
+#include <iostream>
+
+WindowContext::~WindowContext() {
+    if (window != nullptr)
+        glfwDestroyWindow(window);
+    glfwTerminate();
+}
+
+bool WindowContext::create(unsigned int width, unsigned int height, const char *title) {
+    // glfw: initialize and configure
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_COCOA_RETINA_FRAMEBUFFER, GLFW_FALSE);
+#endif
+    glfwWindowHint(GLFW_RESIZABLE, false);
+
+    window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+    if (window == nullptr) {
+        std::cout << "ERROR::CONTEXT: Failed to create GLFW window" << std::endl;
+        return false;
+    }
+    glfwMakeContextCurrent(window);
+
+    // glad: load all OpenGL function pointers
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void WindowContext::pollEvents() {
+    glfwPollEvents();
+}
+
+void WindowContext::setInput(Input *input) {
+    glfwSetWindowUserPointer(window, input);
+    glfwSetKeyCallback(window, keyCallback);
+    glfwSetCursorPosCallback(window, cursorCallback);
+}
+
+void WindowContext::keyCallback(GLFWwindow *window, int key, int /*scancode*/, int action, int /*mods*/) {
+    if (auto *input = static_cast<Input *>(glfwGetWindowUserPointer(window)))
+        input->onKey(key, action);
+}
+
+void WindowContext::cursorCallback(GLFWwindow *window, double x, double y) {
+    if (auto *input = static_cast<Input *>(glfwGetWindowUserPointer(window)))
+        input->onCursor(x, y);
+}
+
+bool WindowContext::shouldClose() const {
+    return glfwWindowShouldClose(window);
+}
+
+void WindowContext::setShouldClose(bool close) {
+    glfwSetWindowShouldClose(window, close);
+}
+
+void WindowContext::swapBuffers() {
+    glfwSwapBuffers(window);
+}
+
+void WindowContext::setSwapInterval(int interval) {
+    glfwSwapInterval(interval);
+}
+
+double WindowContext::getTime() const {
+    return glfwGetTime();
+}
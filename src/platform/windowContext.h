@@ -0,0 +1,37 @@
+#ifndef GRAPHICS_WINDOWCONTEXT_H
+#define GRAPHICS_WINDOWCONTEXT_H
+
+#include "platformContext.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+/**
+ * @brief A visible GLFW window and its OpenGL context
+ */
+class WindowContext : public PlatformContext {
+public:
+    WindowContext() = default;
+
+    /// @brief Destroys the window and terminates GLFW
+    ~WindowContext() override;
+
+    bool create(unsigned int width, unsigned int height, const char *title) override;
+    void pollEvents() override;
+    void setInput(Input *input) override;
+    bool shouldClose() const override;
+    void setShouldClose(bool close) override;
+    void swapBuffers() override;
+    void setSwapInterval(int interval) override;
+    double getTime() const override;
+
+private:
+    /// @brief The actual GLFW window
+    GLFWwindow *window = nullptr;
+
+    /// @brief GLFW callbacks; the window's user pointer holds the Input
+    static void keyCallback(GLFWwindow *window, int key, int scancode, int action, int mods);
+    static void cursorCallback(GLFWwindow *window, double x, double y);
+};
+
+#endif //GRAPHICS_WINDOWCONTEXT_H
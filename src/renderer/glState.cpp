@@ -0,0 +1,162 @@
+#include "glState.h"
+
+GLuint GLState::program = GLState::UNKNOWN;
+GLuint GLState::vertexArray = GLState::UNKNOWN;
+GLuint GLState::buffers[GLState::BufferSlotCount] = {UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN};
+GLuint GLState::textures[GLState::TEXTURE_UNITS] = {
+    UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN,
+    UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN
+};
+GLenum GLState::textureUnit = GLState::UNKNOWN;
+GLuint GLState::blend = GLState::UNKNOWN;
+GLenum GLState::blendSource = GLState::UNKNOWN;
+GLenum GLState::blendDestination = GLState::UNKNOWN;
+unsigned long long GLState::issued = 0;
+unsigned long long GLState::elided = 0;
+
+bool GLState::change(GLuint &cached, GLuint value) {
+    if (cached == value) {
+        elided++;
+        return false;
+    }
+    cached = value;
+    issued++;
+    return true;
+}
+
+int GLState::bufferSlot(GLenum target) {
+    switch (target) {
+        case GL_ARRAY_BUFFER:      return ArrayBuffer;
+        case GL_UNIFORM_BUFFER:    return UniformBuffer;
+        case GL_COPY_READ_BUFFER:  return CopyReadBuffer;
+        case GL_COPY_WRITE_BUFFER: return CopyWriteBuffer;
+        default:                   return BufferSlotCount;
+    }
+}
+
+void GLState::useProgram(GLuint program) {
+    if (change(GLState::program, program))
+        glUseProgram(program);
+}
+
+void GLState::bindVertexArray(GLuint vertexArray) {
+    if (change(GLState::vertexArray, vertexArray))
+        glBindVertexArray(vertexArray);
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer) {
+    int slot = bufferSlot(target);
+    if (slot == BufferSlotCount) {
+        issued++;
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (change(buffers[slot], buffer))
+        glBindBuffer(target, buffer);
+}
+
+void GLState::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    // indexed bindings are not cached, but the call also rebinds the generic target
+    issued++;
+    glBindBufferBase(target, index, buffer);
+    int slot = bufferSlot(target);
+    if (slot != BufferSlotCount)
+        buffers[slot] = buffer;
+}
+
+void GLState::activeTexture(GLenum unit) {
+    if (change(textureUnit, unit))
+        glActiveTexture(unit);
+}
+
+void GLState::bindTexture(GLenum target, GLuint texture) {
+    unsigned int unit = textureUnit - GL_TEXTURE0;
+    if (target != GL_TEXTURE_2D || textureUnit == UNKNOWN || unit >= TEXTURE_UNITS) {
+        issued++;
+        glBindTexture(target, texture);
+        return;
+    }
+    if (change(textures[unit], texture))
+        glBindTexture(target, texture);
+}
+
+void GLState::setBlend(bool enabled) {
+    if (!change(blend, enabled ? GL_TRUE : GL_FALSE))
+        return;
+    if (enabled)
+        glEnable(GL_BLEND);
+    else
+        glDisable(GL_BLEND);
+}
+
+void GLState::blendFunc(GLenum source, GLenum destination) {
+    if (blendSource == source && blendDestination == destination) {
+        elided++;
+        return;
+    }
+    blendSource = source;
+    blendDestination = destination;
+    issued++;
+    glBlendFunc(source, destination);
+}
+
+void GLState::deleteProgram(GLuint program) {
+    // a deleted program stays in use until another is bound, but its name may be reused
+    if (GLState::program == program)
+        GLState::program = UNKNOWN;
+    glDeleteProgram(program);
+}
+
+void GLState::deleteVertexArrays(GLsizei count, const GLuint *vertexArrays) {
+    for (GLsizei i = 0; i < count; i++) {
+        if (vertexArray == vertexArrays[i])
+            vertexArray = 0;
+    }
+    glDeleteVertexArrays(count, vertexArrays);
+}
+
+void GLState::deleteBuffers(GLsizei count, const GLuint *buffers) {
+    for (GLsizei i = 0; i < count; i++) {
+        for (GLuint &bound : GLState::buffers) {
+            if (bound == buffers[i])
+                bound = 0;
+        }
+    }
+    glDeleteBuffers(count, buffers);
+}
+
+void GLState::deleteTextures(GLsizei count, const GLuint *textures) {
+    for (GLsizei i = 0; i < count; i++) {
+        for (GLuint &bound : GLState::textures) {
+            if (bound == textures[i])
+                bound = 0;
+        }
+    }
+    glDeleteTextures(count, textures);
+}
+
+void GLState::invalidate() {
+    program = UNKNOWN;
+    vertexArray = UNKNOWN;
+    for (GLuint &bound : buffers)
+        bound = UNKNOWN;
+    for (GLuint &bound : textures)
+        bound = UNKNOWN;
+    textureUnit = UNKNOWN;
+    blend = UNKNOWN;
+    blendSource = UNKNOWN;
+    blendDestination = UNKNOWN;
+}
+
+unsigned long long GLState::getIssuedCalls() {
+    return issued;
+}
+
+unsigned long long GLState::getElidedCalls() {
+    return elided;
+}
+
+void GLState::resetCounters() {
+    issued = 0;
+    elided = 0;
+}
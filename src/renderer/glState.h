@@ -0,0 +1,91 @@
+#ifndef GRAPHICS_GLSTATE_H
+#define GRAPHICS_GLSTATE_H
+
+#include <glad/glad.h>
+
+/// @brief Shadow copy of the OpenGL binding and blend state that skips redundant calls.
+/// @details Every bind in the engine goes through this class, which remembers what is bound and
+/// only calls into the driver when the value actually changes. Objects must be deleted through
+/// the delete functions here so a recycled GL name is never mistaken for the deleted object.
+/// All state starts out unknown, so the first call for each binding always reaches the driver.
+/// @note GL_ELEMENT_ARRAY_BUFFER is part of the bound VAO, so binds to it are never elided.
+class GLState {
+public:
+    /// @brief glUseProgram
+    static void useProgram(GLuint program);
+
+    /// @brief glBindVertexArray
+    static void bindVertexArray(GLuint vertexArray);
+
+    /// @brief glBindBuffer (GL_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_COPY_READ/WRITE_BUFFER are cached)
+    static void bindBuffer(GLenum target, GLuint buffer);
+
+    /// @brief glBindBufferBase; also updates the generic binding of target, as GL does
+    static void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+    /// @brief glActiveTexture
+    static void activeTexture(GLenum unit);
+
+    /// @brief glBindTexture on the active unit (GL_TEXTURE_2D is cached)
+    static void bindTexture(GLenum target, GLuint texture);
+
+    /// @brief glEnable / glDisable of GL_BLEND
+    static void setBlend(bool enabled);
+
+    /// @brief glBlendFunc
+    static void blendFunc(GLenum source, GLenum destination);
+
+    /// @brief glDeleteProgram, forgetting the program if it is in use
+    static void deleteProgram(GLuint program);
+
+    /// @brief glDeleteVertexArrays, forgetting any that are bound
+    static void deleteVertexArrays(GLsizei count, const GLuint *vertexArrays);
+
+    /// @brief glDeleteBuffers, forgetting any that are bound to a cached target
+    static void deleteBuffers(GLsizei count, const GLuint *buffers);
+
+    /// @brief glDeleteTextures, forgetting any that are bound to a texture unit
+    static void deleteTextures(GLsizei count, const GLuint *textures);
+
+    /// @brief Forgets all state, e.g. after a context change or code that binds GL objects directly
+    static void invalidate();
+
+    /// @brief Number of state calls passed on to the driver
+    static unsigned long long getIssuedCalls();
+
+    /// @brief Number of state calls skipped because they would not have changed anything
+    static unsigned long long getElidedCalls();
+
+    /// @brief Resets both call counters
+    static void resetCounters();
+
+private:
+    /// @brief Value of a cached binding that is not known
+    static const GLuint UNKNOWN = ~0u;
+
+    /// @brief Number of texture units tracked
+    static const int TEXTURE_UNITS = 16;
+
+    /// @brief Indices into buffers[] of the cached buffer targets
+    enum BufferSlot { ArrayBuffer, UniformBuffer, CopyReadBuffer, CopyWriteBuffer, BufferSlotCount };
+
+    static GLuint program;
+    static GLuint vertexArray;
+    static GLuint buffers[BufferSlotCount];
+    static GLuint textures[TEXTURE_UNITS];
+    static GLenum textureUnit;
+    static GLuint blend;
+    static GLenum blendSource, blendDestination;
+
+    static unsigned long long issued;
+    static unsigned long long elided;
+
+    /// @brief Returns the slot for a buffer target, or BufferSlotCount if it is not cached
+    static int bufferSlot(GLenum target);
+
+    /// @brief Updates a cached value, counting the call as issued or elided
+    /// @return true if the driver must be called
+    static bool change(GLuint &cached, GLuint value);
+};
+
+#endif //GRAPHICS_GLSTATE_H
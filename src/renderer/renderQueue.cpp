@@ -0,0 +1,117 @@
+#include "renderQueue.h"
+#include "../util/profiler.h"
+
+#include <algorithm>
+
+RenderQueue::RenderQueue(ShapeRenderer &shapes, FontRenderer &text) : shapeRenderer(shapes), fontRenderer(text) {}
+
+uint64_t RenderQueue::makeKey(RenderLayer layer, unsigned int shader, unsigned int texture, unsigned int mesh, CommandType type) const {
+    // GL names are small integers in practice; masking only risks merging fewer batches, never misdrawing,
+    // because drawBatch() binds the real objects
+    return (static_cast<uint64_t>(layer) & 0xF) << LAYER_SHIFT
+         | (static_cast<uint64_t>(shader) & 0xFFF) << SHADER_SHIFT
+         | (static_cast<uint64_t>(texture) & 0xFFF) << TEXTURE_SHIFT
+         | (static_cast<uint64_t>(mesh) & 0xFF) << MESH_SHIFT
+         | (static_cast<uint64_t>(type) & 0xF) << TYPE_SHIFT
+         | (static_cast<uint64_t>(commands.size()) & ((1u << SEQUENCE_BITS) - 1));
+}
+
+void RenderQueue::submit(const Shape &shape, RenderLayer layer) {
+    submit(shape, shape.getPos(), layer);
+}
+
+void RenderQueue::submit(const Shape &shape, glm::vec2 pos, RenderLayer layer) {
+    if (shape.getMesh() == INVALID_MESH)
+        return;
+    commands.push_back({makeKey(layer, shapeRenderer.getProgram(), 0, shape.getMesh(), CommandType::Shape),
+                        static_cast<uint32_t>(shapes.size())});
+    shapes.push_back({&shape, pos, shape.getMesh(), nullptr, 0});
+}
+
+void RenderQueue::submitInstances(MeshHandle mesh, const ShapeRenderer::Instance *instances, size_t count, RenderLayer layer) {
+    if (mesh == INVALID_MESH || count == 0)
+        return;
+    // same command type as single shapes, so a block batches with the shapes around it
+    commands.push_back({makeKey(layer, shapeRenderer.getProgram(), 0, mesh, CommandType::Shape),
+                        static_cast<uint32_t>(shapes.size())});
+    shapes.push_back({nullptr, glm::vec2(0), mesh, instances, count});
+}
+
+void RenderQueue::submitText(TextHandle handle, RenderLayer layer) {
+    // each retained text has its own VAO, so they share a batch under a common "mesh" slot
+    commands.push_back({makeKey(layer, fontRenderer.getProgram(), fontRenderer.getAtlasTexture(), 0xFF, CommandType::RetainedText),
+                        static_cast<uint32_t>(retainedTexts.size())});
+    retainedTexts.push_back(handle);
+}
+
+void RenderQueue::submitText(std::string_view text, float x, float y, float scale, glm::vec3 color, TextAlign align, RenderLayer layer) {
+    commands.push_back({makeKey(layer, fontRenderer.getProgram(), fontRenderer.getAtlasTexture(), 0xFF, CommandType::DynamicText),
+                        static_cast<uint32_t>(dynamicTexts.size())});
+    dynamicTexts.push_back({textChars.size(), text.size(), x, y, scale, color, align});
+    textChars.append(text);
+}
+
+void RenderQueue::flush() {
+    PROFILE_SCOPE("render queue");
+    // the sequence number makes every key unique, so a plain sort is stable
+    std::sort(commands.begin(), commands.end(), [](const Command &a, const Command &b) {
+        return a.key < b.key;
+    });
+
+    // merge runs of commands whose keys match above the sequence number
+    batchCount = 0;
+    size_t first = 0;
+    for (size_t i = 1; i <= commands.size(); i++) {
+        if (i == commands.size() || (commands[i].key >> SEQUENCE_BITS) != (commands[first].key >> SEQUENCE_BITS)) {
+            drawBatch(first, i);
+            first = i;
+        }
+    }
+
+    commands.clear();
+    shapes.clear();
+    retainedTexts.clear();
+    dynamicTexts.clear();
+    textChars.clear();
+}
+
+void RenderQueue::drawBatch(size_t first, size_t last) {
+    if (first == last)
+        return;
+    batchCount++;
+
+    auto type = static_cast<CommandType>((commands[first].key >> TYPE_SHIFT) & 0xF);
+    switch (type) {
+        case CommandType::Shape: {
+            for (size_t i = first; i < last; i++) {
+                const ShapeCommand &command = shapes[commands[i].index];
+                if (command.shape != nullptr)
+                    shapeRenderer.submit(*command.shape, command.pos);
+                else
+                    shapeRenderer.submitInstances(command.mesh, command.instances, command.instanceCount);
+            }
+            shapeRenderer.flush();
+            break;
+        }
+        case CommandType::RetainedText: {
+            textBatch.clear();
+            for (size_t i = first; i < last; i++)
+                textBatch.push_back(retainedTexts[commands[i].index]);
+            fontRenderer.drawTexts(textBatch.data(), textBatch.size());
+            break;
+        }
+        case CommandType::DynamicText: {
+            for (size_t i = first; i < last; i++) {
+                const DynamicText &text = dynamicTexts[commands[i].index];
+                fontRenderer.addText(std::string_view(textChars).substr(text.offset, text.length),
+                                     text.x, text.y, text.scale, text.color, text.align);
+            }
+            fontRenderer.flush();
+            break;
+        }
+    }
+}
+
+unsigned int RenderQueue::getBatchCount() const {
+    return batchCount;
+}
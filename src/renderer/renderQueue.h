@@ -0,0 +1,118 @@
+#ifndef GRAPHICS_RENDERQUEUE_H
+#define GRAPHICS_RENDERQUEUE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../shapes/shape.h"
+#include "../shapes/shapeRenderer.h"
+#include "../font/fontRenderer.h"
+
+/**
+ * @brief Draw order of queued commands
+ * @details Layers are drawn in this order; within a layer commands are grouped by shader,
+ * texture and mesh, and keep their submission order otherwise.
+ */
+enum class RenderLayer : uint8_t { World, Hud, Text };
+
+/**
+ * @brief Collects the frame's draw commands and submits them in one sorted pass
+ * @details Gameplay code only enqueues. flush() sorts the commands by a 64-bit key
+ * (layer, shader, texture, mesh, sequence) and hands each run of commands with equal state to
+ * its renderer as one batch, so every program, texture and VAO is bound once per batch.
+ * The sequence number makes the sort stable, which keeps blending order within a batch.
+ */
+class RenderQueue {
+public:
+    /// @brief Construct a queue that draws with the given renderers
+    /// @param shapes Renderer for shape commands
+    /// @param text Renderer for text commands
+    RenderQueue(ShapeRenderer &shapes, FontRenderer &text);
+
+    /// @brief Queues a shape
+    /// @details The shape must stay alive until flush()
+    void submit(const Shape &shape, RenderLayer layer = RenderLayer::World);
+
+    /// @brief Queues a shape drawn centered on pos instead of its own position
+    /// @details The shape must stay alive until flush()
+    void submit(const Shape &shape, glm::vec2 pos, RenderLayer layer = RenderLayer::World);
+
+    /// @brief Queues a block of prepared instances drawn with one mesh
+    /// @details The instances are not copied; they must stay alive and unchanged until flush().
+    /// The block sorts and batches like a single shape with that mesh.
+    void submitInstances(MeshHandle mesh, const ShapeRenderer::Instance *instances, size_t count,
+                         RenderLayer layer = RenderLayer::World);
+
+    /// @brief Queues a retained text object
+    void submitText(TextHandle handle, RenderLayer layer = RenderLayer::Text);
+
+    /// @brief Queues one-off text, laid out when the queue is flushed
+    void submitText(std::string_view text, float x, float y, float scale, glm::vec3 color,
+                    TextAlign align = TextAlign::Left, RenderLayer layer = RenderLayer::Text);
+
+    /// @brief Sorts and draws every queued command, then empties the queue
+    void flush();
+
+    /// @brief Number of batches (renderer draws) issued by the last flush()
+    unsigned int getBatchCount() const;
+
+private:
+    enum class CommandType : uint8_t { Shape, RetainedText, DynamicText };
+
+    /// @brief Bit layout of a sort key, from most to least significant:
+    /// layer (4) | shader (12) | texture (12) | mesh (8) | type (4) | sequence (24)
+    static const int SEQUENCE_BITS = 24;
+    static const int TYPE_SHIFT = SEQUENCE_BITS;
+    static const int MESH_SHIFT = TYPE_SHIFT + 4;
+    static const int TEXTURE_SHIFT = MESH_SHIFT + 8;
+    static const int SHADER_SHIFT = TEXTURE_SHIFT + 12;
+    static const int LAYER_SHIFT = SHADER_SHIFT + 12;
+
+    /// @brief A queued draw; index refers into the array for its type
+    struct Command {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    /// @brief A queued shape and where to draw it, or (when shape is null) a block of instances
+    struct ShapeCommand {
+        const Shape *shape;
+        glm::vec2 pos;
+        MeshHandle mesh;
+        const ShapeRenderer::Instance *instances;
+        size_t instanceCount;
+    };
+
+    /// @brief One-off text stored until flush(); the characters live in textChars
+    struct DynamicText {
+        size_t offset, length;
+        float x, y, scale;
+        glm::vec3 color;
+        TextAlign align;
+    };
+
+    ShapeRenderer &shapeRenderer;
+    FontRenderer &fontRenderer;
+
+    /// @brief Queued commands and their payloads (cleared, not deallocated, after each flush)
+    std::vector<Command> commands;
+    std::vector<ShapeCommand> shapes;
+    std::vector<TextHandle> retainedTexts;
+    std::vector<DynamicText> dynamicTexts;
+    std::string textChars;
+
+    /// @brief Scratch list of handles for one retained text batch
+    std::vector<TextHandle> textBatch;
+
+    unsigned int batchCount = 0;
+
+    /// @brief Builds a sort key; the sequence is the command's position in the queue
+    uint64_t makeKey(RenderLayer layer, unsigned int shader, unsigned int texture, unsigned int mesh, CommandType type) const;
+
+    /// @brief Draws commands [first, last), which all share a batch key
+    void drawBatch(size_t first, size_t last);
+};
+
+#endif //GRAPHICS_RENDERQUEUE_H
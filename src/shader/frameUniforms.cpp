@@ -0,0 +1,20 @@
+#include "frameUniforms.h"
+#include "../renderer/glState.h"
+
+FrameUniforms::FrameUniforms() {
+    glGenBuffers(1, &UBO);
+    GLState::bindBuffer(GL_UNIFORM_BUFFER, UBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Data), nullptr, GL_DYNAMIC_DRAW);
+    GLState::bindBuffer(GL_UNIFORM_BUFFER, 0);
+    GLState::bindBufferBase(GL_UNIFORM_BUFFER, BINDING, UBO);
+}
+
+FrameUniforms::~FrameUniforms() {
+    GLState::deleteBuffers(1, &UBO);
+}
+
+void FrameUniforms::update(const glm::mat4 &projection, const glm::vec2 &viewportSize, float time) {
+    Data data = {projection, viewportSize, time, 0.0f};
+    GLState::bindBuffer(GL_UNIFORM_BUFFER, UBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Data), &data);
+}
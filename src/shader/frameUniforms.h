@@ -0,0 +1,50 @@
+#ifndef GRAPHICS_FRAMEUNIFORMS_H
+#define GRAPHICS_FRAMEUNIFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+/// @brief Per-frame constants shared by every shader through a std140 uniform block.
+/// @details Shaders declare the block as
+/// @code
+/// layout (std140) uniform FrameData {
+///     mat4 projection;
+///     vec2 viewportSize;
+///     float time;
+/// };
+/// @endcode
+/// and are connected to it with Shader::bindUniformBlock(FrameUniforms::BLOCK_NAME, FrameUniforms::BINDING).
+class FrameUniforms {
+public:
+    /// @brief The uniform buffer binding point the block is bound to
+    static const GLuint BINDING = 0;
+
+    /// @brief The name of the uniform block in GLSL
+    static constexpr const char *BLOCK_NAME = "FrameData";
+
+    /// @brief Creates the uniform buffer and binds it to BINDING
+    FrameUniforms();
+
+    /// @brief Deletes the uniform buffer
+    ~FrameUniforms();
+
+    /// @brief Uploads this frame's constants (call once per frame, before drawing)
+    /// @param projection The projection matrix used by all 2D rendering
+    /// @param viewportSize The viewport size in pixels
+    /// @param time The time since startup in seconds
+    void update(const glm::mat4 &projection, const glm::vec2 &viewportSize, float time);
+
+private:
+    /// @brief CPU mirror of the block in std140 layout
+    struct Data {
+        glm::mat4 projection;  // offset 0
+        glm::vec2 viewportSize; // offset 64
+        float time;             // offset 72
+        float padding;          // block size is rounded up to 80
+    };
+
+    /// @brief The uniform buffer object
+    GLuint UBO;
+};
+
+#endif //GRAPHICS_FRAMEUNIFORMS_H
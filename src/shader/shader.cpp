@@ -1,89 +1,204 @@
 #include "shader.h"
+#include "../renderer/glState.h"
 
 Shader &Shader::use() {
-    glUseProgram(this->ID);
+    GLState::useProgram(this->ID);
     return *this;
 }
 
 void Shader::compile(const char* vertexSource, const char* fragmentSource, const char* geometrySource) {
-    unsigned int sVertex, sFragment, gShader;
-
-    // vertex Shader
-    sVertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(sVertex, 1, &vertexSource, NULL);
-    glCompileShader(sVertex);
-    checkCompileErrors(sVertex, "VERTEX");
-
-    // fragment Shader
-    sFragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(sFragment, 1, &fragmentSource, NULL);
-    glCompileShader(sFragment);
-    checkCompileErrors(sFragment, "FRAGMENT");
-
-    // if geometry shader source code is given, also compile geometry shader
-    if (geometrySource != nullptr) {
-        gShader = glCreateShader(GL_GEOMETRY_SHADER);
-        glShaderSource(gShader, 1, &geometrySource, NULL);
-        glCompileShader(gShader);
-        checkCompileErrors(gShader, "GEOMETRY");
+    beginCompile(vertexSource, fragmentSource, geometrySource);
+    finishCompile();
+}
+
+void Shader::beginCompile(const char* vertexSource, const char* fragmentSource, const char* geometrySource) {
+    // No status is queried here: with GL_KHR_parallel_shader_compile the driver keeps compiling
+    // in the background until finishCompile() asks for the result.
+    const char* sources[3] = {vertexSource, fragmentSource, geometrySource};
+    const GLenum types[3] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER};
+
+    // vertex, fragment and (if geometry shader source code is given) geometry shader
+    for (int i = 0; i < 3; i++) {
+        pendingShaders[i] = 0;
+        if (sources[i] == nullptr)
+            continue;
+        pendingShaders[i] = glCreateShader(types[i]);
+        glShaderSource(pendingShaders[i], 1, &sources[i], NULL);
+        glCompileShader(pendingShaders[i]);
     }
 
     // shader program
     this->ID = glCreateProgram();
-    glAttachShader(this->ID, sVertex);
-    glAttachShader(this->ID, sFragment);
-    if (geometrySource != nullptr)
-        glAttachShader(this->ID, gShader);
-
+    for (unsigned int shader : pendingShaders) {
+        if (shader != 0)
+            glAttachShader(this->ID, shader);
+    }
+#ifdef SHADER_PROGRAM_BINARY
+    // allow the linked program to be saved to the shader cache
+    if (glProgramParameteri != nullptr)
+        glProgramParameteri(this->ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
     glLinkProgram(this->ID);
-    checkCompileErrors(this->ID, "PROGRAM");
+}
+
+bool Shader::finishCompile() {
+    const char* typeNames[3] = {"VERTEX", "FRAGMENT", "GEOMETRY"};
+    for (int i = 0; i < 3; i++) {
+        if (pendingShaders[i] != 0)
+            checkCompileErrors(pendingShaders[i], typeNames[i]);
+    }
+    bool linked = checkCompileErrors(this->ID, "PROGRAM");
+    introspectUniforms();
 
     // delete the shaders as they're linked into our program now and no longer necessary
-    glDeleteShader(sVertex);
-    glDeleteShader(sFragment);
-    if (geometrySource != nullptr)
-        glDeleteShader(gShader);
+    for (unsigned int &shader : pendingShaders) {
+        if (shader != 0)
+            glDeleteShader(shader);
+        shader = 0;
+    }
+    return linked;
+}
+
+bool Shader::loadBinary(GLenum format, const void* binary, GLsizei length) {
+#ifdef SHADER_PROGRAM_BINARY
+    if (glProgramBinary == nullptr)
+        return false;
+    this->ID = glCreateProgram();
+    glProgramBinary(this->ID, format, binary, length);
+
+    // a driver update or different GPU makes old binaries fail to load; that is not an error
+    GLint success = GL_FALSE;
+    glGetProgramiv(this->ID, GL_LINK_STATUS, &success);
+    if (!success) {
+        GLState::deleteProgram(this->ID);
+        this->ID = 0;
+        return false;
+    }
+    introspectUniforms();
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Shader::getBinary(GLenum &format, std::vector<char> &binary) const {
+#ifdef SHADER_PROGRAM_BINARY
+    if (glGetProgramBinary == nullptr)
+        return false;
+    GLint length = 0;
+    glGetProgramiv(this->ID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return false;
+    binary.resize(length);
+    glGetProgramBinary(this->ID, length, nullptr, &format, binary.data());
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Shader::introspectUniforms() {
+    uniforms.clear();
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(this->ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(this->ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::vector<char> name(maxLength > 0 ? maxLength : 1);
+    for (GLint i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(this->ID, i, maxLength, &length, &size, &type, name.data());
+
+        // Uniforms inside blocks have no location and are not set through this table
+        GLint location = glGetUniformLocation(this->ID, name.data());
+        if (location < 0)
+            continue;
+
+        // Arrays are reported as "name[0]", but callers look them up by "name"
+        string uniformName(name.data(), length);
+        if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+            uniformName.resize(uniformName.size() - 3);
+        uniforms.push_back({uniformName, location});
+    }
+}
+
+UniformId Shader::uniform(const char *name) const {
+    for (size_t i = 0; i < uniforms.size(); i++) {
+        if (uniforms[i].name == name)
+            return static_cast<UniformId>(i);
+    }
+    return INVALID_UNIFORM;
+}
+
+void Shader::bindUniformBlock(const char *blockName, GLuint binding) const {
+    GLuint index = glGetUniformBlockIndex(this->ID, blockName);
+    if (index != GL_INVALID_INDEX)
+        glUniformBlockBinding(this->ID, index, binding);
 }
 
 void Shader::setFloat(const char *name, float value) const {
-    glUniform1f(glGetUniformLocation(this->ID, name), value);
+    setFloat(uniform(name), value);
 }
 
 void Shader::setInteger(const char *name, int value) const {
-    glUniform1i(glGetUniformLocation(this->ID, name), value);
-
+    setInteger(uniform(name), value);
 }
 
 void Shader::setVector2f(const char *name, float x, float y) const {
-    glUniform2f(glGetUniformLocation(this->ID, name), x, y);
+    setVector2f(uniform(name), glm::vec2(x, y));
 }
 
 void Shader::setVector2f(const char *name, const glm::vec2 &value) const {
-    glUniform2f(glGetUniformLocation(this->ID, name), value.x, value.y);
+    setVector2f(uniform(name), value);
 }
 
 void Shader::setVector3f(const char *name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(this->ID, name), x, y, z);
+    setVector3f(uniform(name), glm::vec3(x, y, z));
 }
 
 void Shader::setVector3f(const char *name, const glm::vec3 &value) const {
-    glUniform3f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z);
+    setVector3f(uniform(name), value);
 }
 
 void Shader::setVector4f(const char *name, float x, float y, float z, float w) const {
-    glUniform4f(glGetUniformLocation(this->ID, name), x, y, z, w);
+    setVector4f(uniform(name), glm::vec4(x, y, z, w));
 }
 
 void Shader::setVector4f(const char *name, const glm::vec4 &value) const {
-    glUniform4f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z, value.w);
+    setVector4f(uniform(name), value);
 }
 
 void Shader::setMatrix4(const char *name, const glm::mat4 &matrix) const {
-    glUniformMatrix4fv(glGetUniformLocation(this->ID, name), 1, false, glm::value_ptr(matrix));
+    setMatrix4(uniform(name), matrix);
 }
 
+void Shader::setFloat(UniformId id, float value) const {
+    glUniform1f(location(id), value);
+}
+
+void Shader::setInteger(UniformId id, int value) const {
+    glUniform1i(location(id), value);
+}
 
-void Shader::checkCompileErrors(unsigned int object, string type) {
+void Shader::setVector2f(UniformId id, const glm::vec2 &value) const {
+    glUniform2f(location(id), value.x, value.y);
+}
+
+void Shader::setVector3f(UniformId id, const glm::vec3 &value) const {
+    glUniform3f(location(id), value.x, value.y, value.z);
+}
+
+void Shader::setVector4f(UniformId id, const glm::vec4 &value) const {
+    glUniform4f(location(id), value.x, value.y, value.z, value.w);
+}
+
+void Shader::setMatrix4(UniformId id, const glm::mat4 &matrix) const {
+    glUniformMatrix4fv(location(id), 1, false, glm::value_ptr(matrix));
+}
+
+bool Shader::checkCompileErrors(unsigned int object, string type) {
     int success;
     char infoLog[1024];
 
@@ -106,4 +221,5 @@ void Shader::checkCompileErrors(unsigned int object, string type) {
                       << endl;
         }
     }
-}
\ No newline at end of file
+    return success;
+}
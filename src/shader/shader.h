@@ -5,8 +5,22 @@
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include <string>
+#include <vector>
 using std::string, std::ifstream, std::stringstream, std::cout, std::endl;
 
+// Program binaries need GL 4.1 or ARB_get_program_binary in the GLAD loader (checked again at runtime)
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+#define SHADER_PROGRAM_BINARY
+#endif
+
+/// @brief Pre-resolved index into a shader's uniform table.
+/// @details Obtained once from Shader::uniform() and passed to the setters on the draw path.
+using UniformId = int;
+
+/// @brief Value of a UniformId for a uniform that does not exist (setters ignore it).
+const UniformId INVALID_UNIFORM = -1;
+
 /// @brief General purpose shader object.
 /// @details Compiles from file, generates compile/link-time error messages and hosts several utility functions for easy management.
 class Shader {
@@ -29,6 +43,43 @@ class Shader {
         /// @param geometrySource the source code for the geometry shader (optional)
         void compile(const char *vertexSource, const char *fragmentSource, const char *geometrySource = nullptr); // note: geometry source code is optional
 
+        /// @brief Starts compiling and linking without waiting for the result
+        /// @details Lets the driver compile several programs concurrently (GL_KHR_parallel_shader_compile).
+        /// Must be followed by finishCompile().
+        /// @param vertexSource the source code for the vertex shader
+        /// @param fragmentSource the source code for the fragment shader
+        /// @param geometrySource the source code for the geometry shader (optional)
+        void beginCompile(const char *vertexSource, const char *fragmentSource, const char *geometrySource = nullptr);
+
+        /// @brief Waits for compilation, prints any errors and builds the uniform table
+        /// @return true if the program linked
+        bool finishCompile();
+
+        /// @brief Creates the program from a binary saved by getBinary()
+        /// @param format the binary format reported by the driver
+        /// @param binary the program binary
+        /// @param length the size of the binary in bytes
+        /// @return true if the driver accepted the binary
+        bool loadBinary(GLenum format, const void *binary, GLsizei length);
+
+        /// @brief Retrieves the linked program as a driver-specific binary
+        /// @param format set to the binary format
+        /// @param binary filled with the program binary
+        /// @return true if the driver supports program binaries
+        bool getBinary(GLenum &format, std::vector<char> &binary) const;
+
+        /// @brief Looks up a uniform in the table built at link time
+        /// @details Intended for initialization; resolve IDs once and keep them.
+        /// @param name name of the uniform
+        /// @return the uniform's ID, or INVALID_UNIFORM if the program has no such active uniform
+        UniformId uniform(const char *name) const;
+
+        /// @brief Connects a uniform block in this program to a uniform buffer binding point
+        /// @details Does nothing if the program has no block with that name
+        /// @param blockName name of the uniform block in GLSL
+        /// @param binding the binding point the buffer is bound to
+        void bindUniformBlock(const char *blockName, GLuint binding) const;
+
         // ------------------------------------------------------------------------
         // utility functions
         // ------------------------------------------------------------------------
@@ -87,11 +138,43 @@ class Shader {
         /// @param useShader boolean to indicate whether to use this shader
         void setMatrix4(const char *name, const glm::mat4 &matrix) const;
 
+        // ------------------------------------------------------------------------
+        // pre-resolved uniform setters (no string lookups, used on the draw path)
+        // ------------------------------------------------------------------------
+
+        void setFloat(UniformId id, float value) const;
+        void setInteger(UniformId id, int value) const;
+        void setVector2f(UniformId id, const glm::vec2 &value) const;
+        void setVector3f(UniformId id, const glm::vec3 &value) const;
+        void setVector4f(UniformId id, const glm::vec4 &value) const;
+        void setMatrix4(UniformId id, const glm::mat4 &matrix) const;
+
     private:
+        /// @brief An active uniform found by introspection at link time
+        struct Uniform {
+            string name;
+            GLint location;
+        };
+
+        /// @brief Shader objects between beginCompile() and finishCompile() (0 if unused)
+        unsigned int pendingShaders[3] = {0, 0, 0};
+
+        /// @brief Flat table of active uniforms, indexed by UniformId
+        std::vector<Uniform> uniforms;
+
+        /// @brief Fills the uniform table using glGetActiveUniform
+        void introspectUniforms();
+
+        /// @brief Returns the GL location for a uniform ID (-1, which GL ignores, if invalid)
+        GLint location(UniformId id) const {
+            return id >= 0 && id < static_cast<UniformId>(uniforms.size()) ? uniforms[id].location : -1;
+        }
+
         /// @brief Checks if compilation or linking failed and if so, print the error logs
         /// @param object the shader object to check
         /// @param type the type of shader object (vertex, fragment, geometry)
-        void checkCompileErrors(unsigned int object, std::string type);
+        /// @return true if compilation or linking succeeded
+        bool checkCompileErrors(unsigned int object, std::string type);
 };
 
 #endif
@@ -1,63 +1,187 @@
 #include "shaderManager.h"
+#include "../renderer/glState.h"
 #include <fstream>
 #include <sstream>
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
 
+namespace {
+    /// @brief Marks a shader cache file ("CDPB")
+    const uint32_t PROGRAM_CACHE_MAGIC = 0x42504443;
+
+    /// @brief 64-bit FNV-1a, used to key cached programs
+    uint64_t hashBytes(uint64_t hash, const char *bytes) {
+        if (bytes == nullptr)
+            return hash;
+        for (; *bytes != '\0'; bytes++) {
+            hash ^= static_cast<unsigned char>(*bytes);
+            hash *= 1099511628211ull;
+        }
+        // separate fields so "ab" + "c" and "a" + "bc" hash differently
+        hash ^= 0xff;
+        return hash * 1099511628211ull;
+    }
+}
 
 ShaderManager::~ShaderManager() {
     clear();
 }
 
-Shader ShaderManager::loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name) {
-    return shaders[name] = loadShaderFromFile(vShaderFile, fShaderFile, gShaderFile);
+ShaderHandle ShaderManager::loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name) {
+    // retrieve the vertex/fragment (and optional geometry) source code from filePath
+    std::string vertexCode = readSource(vShaderFile);
+    std::string fragmentCode = readSource(fShaderFile);
+    std::string geometryCode = gShaderFile != nullptr ? readSource(gShaderFile) : "";
+    return loadShaderFromSource(vertexCode.c_str(), fragmentCode.c_str(),
+                                gShaderFile != nullptr ? geometryCode.c_str() : nullptr, std::move(name));
+}
+
+ShaderHandle ShaderManager::loadShaderFromSource(const char *vShaderCode, const char *fShaderCode, const char *gShaderCode, std::string name) {
+    return loadShadersFromSource({{vShaderCode, fShaderCode, gShaderCode, std::move(name)}}).front();
+}
+
+std::vector<ShaderHandle> ShaderManager::loadShadersFromSource(const std::vector<ShaderSource> &sources) {
+#ifdef GL_KHR_parallel_shader_compile
+    // let the driver use as many compiler threads as it likes
+    if (GLAD_GL_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+#endif
+
+    // 1. take cache hits, and start compiling every miss without waiting on any of them
+    std::vector<ShaderHandle> handles;
+    std::vector<std::string> paths;
+    std::vector<bool> compiled;
+    for (const ShaderSource &source : sources) {
+        Shader shader;
+        std::string path = cachePath(source);
+        bool cached = loadCachedProgram(path, shader);
+        if (!cached)
+            shader.beginCompile(source.vertex, source.fragment, source.geometry);
+
+        shaders.push_back(shader);
+        names.push_back(source.name);
+        handles.push_back(static_cast<ShaderHandle>(shaders.size() - 1));
+        paths.push_back(path);
+        compiled.push_back(!cached);
+    }
+
+    // 2. collect the results and cache the new binaries
+    for (size_t i = 0; i < handles.size(); i++) {
+        if (!compiled[i])
+            continue;
+        Shader &shader = shaders[handles[i]];
+        if (shader.finishCompile())
+            saveCachedProgram(paths[i], shader);
+    }
+    return handles;
+}
+
+Shader &ShaderManager::getShader(ShaderHandle handle) {
+    return shaders[handle];
 }
 
-Shader &ShaderManager::getShader(std::string name) {
-    return shaders[name];
+ShaderHandle ShaderManager::findShader(const std::string &name) const {
+    for (size_t i = 0; i < names.size(); i++) {
+        if (names[i] == name)
+            return static_cast<ShaderHandle>(i);
+    }
+    assert(false && "ShaderManager::findShader: unknown shader name");
+    return 0;
+}
+
+void ShaderManager::setCacheDirectory(std::string directory) {
+    cacheDirectory = std::move(directory);
 }
 
 void ShaderManager::clear() {
-    // delete all shaders: "iter" here is const std::pair<std::string, Shader>&, so we need to use
-    // "iter.second" to get the Shader, and delete the program by ID
-    for (const auto &iter: shaders)
-        glDeleteProgram(iter.second.ID);
+    // delete all shader programs by ID
+    for (const Shader &shader : shaders)
+        GLState::deleteProgram(shader.ID);
+    shaders.clear();
+    names.clear();
 }
 
-Shader ShaderManager::loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile) {
-    // 1. retrieve the vertex/fragment source code from filePath
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::string geometryCode;
+std::string ShaderManager::readSource(const char *path) {
     try {
-        // open files
-        std::ifstream vertexShaderFile(vShaderFile);
-        std::ifstream fragmentShaderFile(fShaderFile);
-        std::stringstream vShaderStream, fShaderStream;
-        // read file's buffer contents into streams
-        vShaderStream << vertexShaderFile.rdbuf();
-        fShaderStream << fragmentShaderFile.rdbuf();
-        // close file handlers
-        vertexShaderFile.close();
-        fragmentShaderFile.close();
+        // open file and read its buffer contents into a stream
+        std::ifstream shaderFile(path);
+        std::stringstream shaderStream;
+        shaderStream << shaderFile.rdbuf();
+        shaderFile.close();
         // convert stream into string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-        // if geometry shader path is present, also load a geometry shader
-        if (gShaderFile != nullptr) {
-            std::ifstream geometryShaderFile(gShaderFile);
-            std::stringstream gShaderStream;
-            gShaderStream << geometryShaderFile.rdbuf();
-            geometryShaderFile.close();
-            geometryCode = gShaderStream.str();
-        }
+        return shaderStream.str();
     }
     catch (std::exception &e) {
         std::cout << "ERROR::SHADER: Failed to read shader files" << std::endl;
     }
-    const char *vShaderCode = vertexCode.c_str();
-    const char *fShaderCode = fragmentCode.c_str();
-    const char *gShaderCode = geometryCode.c_str();
-    // 2. now create shader object from source code
-    Shader shader;
-    shader.compile(vShaderCode, fShaderCode, gShaderFile != nullptr ? gShaderCode : nullptr);
-    return shader;
-}
\ No newline at end of file
+    return "";
+}
+
+std::string ShaderManager::cachePath(const ShaderSource &source) const {
+#ifdef SHADER_PROGRAM_BINARY
+    if (cacheDirectory.empty() || glProgramBinary == nullptr)
+        return "";
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats == 0)
+        return "";
+
+    // a binary is only valid for the exact sources and driver that produced it
+    uint64_t hash = 14695981039346656037ull;
+    hash = hashBytes(hash, reinterpret_cast<const char *>(glGetString(GL_VENDOR)));
+    hash = hashBytes(hash, reinterpret_cast<const char *>(glGetString(GL_RENDERER)));
+    hash = hashBytes(hash, reinterpret_cast<const char *>(glGetString(GL_VERSION)));
+    hash = hashBytes(hash, source.vertex);
+    hash = hashBytes(hash, source.fragment);
+    hash = hashBytes(hash, source.geometry);
+
+    char fileName[32];
+    std::snprintf(fileName, sizeof(fileName), "%016llx.bin", static_cast<unsigned long long>(hash));
+    return cacheDirectory + "/" + fileName;
+#else
+    return "";
+#endif
+}
+
+bool ShaderManager::loadCachedProgram(const std::string &path, Shader &shader) const {
+    if (path.empty())
+        return false;
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    uint32_t header[2] = {0, 0}; // magic, binary format
+    if (!file.read(reinterpret_cast<char *>(header), sizeof(header)) || header[0] != PROGRAM_CACHE_MAGIC)
+        return false;
+
+    // the payload is the rest of the file
+    file.seekg(0, std::ios::end);
+    std::streamoff size = static_cast<std::streamoff>(file.tellg()) - static_cast<std::streamoff>(sizeof(header));
+    if (size <= 0)
+        return false;
+    std::vector<char> binary(static_cast<size_t>(size));
+    file.seekg(sizeof(header), std::ios::beg);
+    file.read(binary.data(), size);
+    if (file.gcount() != size)
+        return false;
+    return shader.loadBinary(header[1], binary.data(), static_cast<GLsizei>(binary.size()));
+}
+
+void ShaderManager::saveCachedProgram(const std::string &path, const Shader &shader) const {
+    if (path.empty())
+        return;
+    GLenum format = 0;
+    std::vector<char> binary;
+    if (!shader.getBinary(format, binary))
+        return;
+
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory, error);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return;
+    uint32_t header[2] = {PROGRAM_CACHE_MAGIC, format};
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    file.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+}
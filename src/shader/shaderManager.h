@@ -3,44 +3,106 @@
 
 #include "shader.h"
 
-#include <map>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
 #include <iostream>
 
+/// @brief Integer handle to a shader stored in the ShaderManager.
+using ShaderHandle = unsigned int;
+
+/// @brief Source code of one shader program, passed to ShaderManager::loadShadersFromSource().
+struct ShaderSource {
+    const char *vertex;
+    const char *fragment;
+    /// @brief Geometry shader source (optional, may be nullptr)
+    const char *geometry;
+    /// @brief Name used to find the shader later with findShader()
+    std::string name;
+};
+
 class ShaderManager {
 public:
     /// @brief Default constructor
     ShaderManager() = default;
     /// @brief Default destructor
-    /// @details Clears the shaders map
+    /// @details Clears the shaders
     ~ShaderManager();
 
 
-    /// @brief Calls loadShaderFromFile() and stores the shader in the shaders map
+    /// @brief Reads the shader files and compiles them with loadShaderFromSource()
     /// @param vShaderFile The vertex shader file
     /// @param fShaderFile The fragment shader file
     /// @param gShaderFile The geometry shader file (optional)
-    /// @param name Name used for the shader in the shaders map
-    /// @return The shader that was loaded
-    Shader loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name);
+    /// @param name Name used to find the shader later with findShader()
+    /// @return Handle of the shader that was loaded
+    ShaderHandle loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name);
+
+    /// @brief Compiles a shader from source already in memory and stores the shader
+    /// @details Used for shaders baked into the asset bundle
+    /// @param vShaderCode The vertex shader source
+    /// @param fShaderCode The fragment shader source
+    /// @param gShaderCode The geometry shader source (optional)
+    /// @param name Name used to find the shader later with findShader()
+    /// @return Handle of the shader that was compiled
+    ShaderHandle loadShaderFromSource(const char *vShaderCode, const char *fShaderCode, const char *gShaderCode, std::string name);
+
+    /// @brief Loads several shader programs at once
+    /// @details Each program is first looked up in the program binary cache. All misses are
+    /// submitted to the driver before any result is read, so drivers with
+    /// GL_KHR_parallel_shader_compile compile them concurrently. Newly linked programs are
+    /// then written back to the cache.
+    /// @param sources The programs to load
+    /// @return The handle of each program, in the same order as sources
+    std::vector<ShaderHandle> loadShadersFromSource(const std::vector<ShaderSource> &sources);
+
+    /// @brief Returns a reference to the shader with the given handle
+    /// @details References stay valid for the lifetime of the manager
+    /// @param handle The handle returned by loadShader()
+    /// @return The shader with the given handle
+    Shader& getShader(ShaderHandle handle);
+
+    /// @brief Finds the handle of a shader by name
+    /// @details Intended for initialization; keep the handle rather than looking it up per draw
+    /// @param name The name the shader was loaded with
+    /// @return The shader's handle (asserts that the shader exists)
+    ShaderHandle findShader(const std::string &name) const;
 
-    /// @brief Returns a reference to the shader with the given name in the shaders map
-    /// @param name The name of the shader
-    /// @return The shader with the given name
-    Shader& getShader(std::string name);
+    /// @brief Sets the directory linked program binaries are cached in
+    /// @details An empty string disables the cache
+    /// @param directory The cache directory (created on first write)
+    void setCacheDirectory(std::string directory);
 
-     /// @brief Clears the shaders map
+     /// @brief Deletes all shader programs
     void clear();
 
+    /// @brief Reads a shader source file
+    /// @details Does not touch OpenGL, so it can run on any thread
+    /// @param path The path to the file
+    /// @return The file contents (empty if the file could not be read)
+    static std::string readSource(const char *path);
+
 private:
-    /// @brief A map of shaders, with the key being the name of the shader
-    std::map<std::string, Shader> shaders;
-
-     /// @brief Loads and compiles a shader from a file
-     /// @details This function is private because we only want to load shaders from within this class
-     /// @param vShaderFile The vertex shader file
-     /// @param fShaderFile The fragment shader file
-     /// @param gShaderFile The geometry shader file (optional)
-     /// @return The shader that was loaded
-    Shader loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile=nullptr);};
+    /// @brief The loaded shaders, indexed by handle
+    /// @details A deque so references handed out by getShader() survive later loads
+    std::deque<Shader> shaders;
+
+    /// @brief The name of each shader, indexed by handle
+    std::deque<std::string> names;
+
+    /// @brief Where program binaries are cached ("" disables the cache)
+    std::string cacheDirectory = "shader_cache";
+
+    /// @brief Returns the cache file for a program
+    /// @details Keyed by a hash of the sources and the driver's vendor, renderer and version strings
+    std::string cachePath(const ShaderSource &source) const;
+
+    /// @brief Tries to create a program from the binary cache
+    bool loadCachedProgram(const std::string &path, Shader &shader) const;
+
+    /// @brief Writes a linked program to the binary cache
+    void saveCachedProgram(const std::string &path, const Shader &shader) const;
+};
 
 #endif //GRAPHICS_SHADERMANAGER_H
@@ -0,0 +1,58 @@
+#include "meshRegistry.h"
+#include "../renderer/glState.h"
+
+Mesh MeshRegistry::meshes[static_cast<unsigned int>(MeshType::Count)];
+
+MeshHandle MeshRegistry::acquire(MeshType type) {
+    return static_cast<MeshHandle>(type);
+}
+
+const Mesh& MeshRegistry::getMesh(MeshHandle handle) {
+    Mesh& mesh = meshes[handle];
+    if (mesh.VBO == 0)
+        upload(static_cast<MeshType>(handle), mesh);
+    return mesh;
+}
+
+void MeshRegistry::clear() {
+    for (Mesh& mesh : meshes) {
+        if (mesh.VBO != 0) {
+            GLState::deleteBuffers(1, &mesh.VBO);
+            GLState::deleteBuffers(1, &mesh.EBO);
+        }
+        mesh.VBO = mesh.EBO = 0;
+    }
+}
+
+void MeshRegistry::upload(MeshType type, Mesh& mesh) {
+    switch (type) {
+        case MeshType::Quad: {
+            // Unit quad centered on the origin, scaled and moved per instance in shape.vert
+            float vertices[] = {
+                    0.5f, -0.5f,  // bottom right corner
+                    -0.5f, -0.5f, // bottom left corner
+                    -0.5f, 0.5f,  // top left corner
+                    0.5f, 0.5f    // top right corner
+            };
+            unsigned int indices[] = {
+                    0, 1, 2, // First triangle
+                    2, 3, 0  // Second triangle
+            };
+
+            glGenBuffers(1, &mesh.VBO);
+            GLState::bindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+            GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+
+            // The EBO is attached to a VAO by the renderer, so it is only filled here
+            glGenBuffers(1, &mesh.EBO);
+            GLState::bindBuffer(GL_COPY_WRITE_BUFFER, mesh.EBO);
+            glBufferData(GL_COPY_WRITE_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+            GLState::bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            mesh.indexCount = 6;
+            break;
+        }
+        case MeshType::Count:
+            break;
+    }
+}
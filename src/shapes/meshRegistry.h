@@ -0,0 +1,53 @@
+#ifndef GRAPHICS_MESHREGISTRY_H
+#define GRAPHICS_MESHREGISTRY_H
+
+#include <glad/glad.h>
+
+/// @brief The kinds of geometry shapes can be drawn with.
+enum class MeshType : unsigned int { Quad, Count };
+
+/// @brief Lightweight handle a shape holds instead of owning its own GL buffers.
+using MeshHandle = unsigned int;
+
+/// @brief Value of a handle that does not reference a mesh.
+const MeshHandle INVALID_MESH = ~0u;
+
+/// @brief GPU geometry shared by every shape of one MeshType.
+struct Mesh {
+    /// @brief Vertex and element buffers (0 until the mesh is first uploaded)
+    GLuint VBO = 0, EBO = 0;
+    /// @brief Number of indices to draw
+    GLsizei indexCount = 0;
+};
+
+/// @brief Owns exactly one GPU mesh per MeshType and hands out handles to it.
+/// @details The meshes live for the whole process: handles are plain indices that shapes copy
+/// freely and never give back, and acquiring one never touches OpenGL. The GL buffers are
+/// created the first time a renderer asks for the mesh and kept until clear(), so they are
+/// reused across game restarts.
+class MeshRegistry {
+public:
+    /// @brief Returns the handle of the mesh of the given type
+    /// @param type The geometry the caller wants to use
+    /// @return A handle to the shared mesh
+    static MeshHandle acquire(MeshType type);
+
+    /// @brief Returns the GPU mesh for a handle, uploading it on first use
+    /// @note Requires a current OpenGL context
+    /// @param handle The mesh handle
+    /// @return The shared mesh
+    static const Mesh& getMesh(MeshHandle handle);
+
+    /// @brief Deletes all GPU meshes; handles stay valid and re-upload on next use
+    /// @note Must be called while the OpenGL context is still alive
+    static void clear();
+
+private:
+    /// @brief One mesh per MeshType, indexed by handle
+    static Mesh meshes[static_cast<unsigned int>(MeshType::Count)];
+
+    /// @brief Creates the VBO and EBO for a mesh type
+    static void upload(MeshType type, Mesh& mesh);
+};
+
+#endif //GRAPHICS_MESHREGISTRY_H
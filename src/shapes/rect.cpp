@@ -3,52 +3,16 @@
 
 Rect::Rect(Shader & shader, vec2 pos, vec2 size, struct color color)
         : Shape(shader, pos, size, color) {
-    initVectors();
-    initVAO();
-    initVBO();
-    initEBO();
+    mesh = MeshRegistry::acquire(MeshType::Quad);
 }
 
 Rect::Rect(Shader & shader, vec2 pos, vec2 size, struct color color, vec2 velocity)
         : Shape(shader, pos, size, color) {
-    initVectors();
-    initVAO();
-    initVBO();
-    initEBO();
+    mesh = MeshRegistry::acquire(MeshType::Quad);
 }
 
-Rect::Rect(Rect const& other) : Shape(other) {
-    initVectors();
-    initVAO();
-    initVBO();
-    initEBO();
-}
-
-Rect::~Rect() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-}
+Rect::Rect(Rect const& other) : Shape(other) {}
 
-void Rect::draw() const {
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-}
-
-void Rect::initVectors() {
-    this->vertices.insert(vertices.end(), {
-            // TO DO: Add other three corners here
-            0.5f, -0.5f,  // x, y of bottom right corner
-            -0.5f, -0.5f, // bottom left corner
-            -0.5f, 0.5f, // top left corner
-            0.5f, 0.5f // top right corner
-    });
-
-    this->indices.insert(indices.end(), {
-            0, 1, 2, // First triangle
-            2, 3, 0  // Second triangle
-    });
-}
 // Overridden Getters from Shape
 float Rect::getLeft() const        { return pos.x - (size.x / 2); }
 float Rect::getRight() const       { return pos.x + (size.x / 2); }
@@ -5,6 +5,7 @@
 #include <vector>
 #include "../shader/shader.h"
 #include "../util/color.h"
+#include "meshRegistry.h"
 
 using std::vector, glm::vec2, glm::vec3, glm::vec4, glm::mat4, glm::translate, glm::scale;
 
@@ -23,23 +24,6 @@ public:
     /// @brief Destroy the Shape object
     virtual ~Shape() = default;
 
-    // --------------------------------------------------------
-    // Initialization functions
-    // --------------------------------------------------------
-
-    /// @brief Initializes the VAO.
-    /// @details This function is called in the derived classes' constructor.
-    unsigned int initVAO();
-
-    /// @brief Initializes the VBO.
-    /// @details This function is called in the derived classes' constructor.
-    void initVBO();
-
-    /// @brief Initializes the EBO.
-    /// @details This function is called in the derived classes' constructor.
-    /// @details If function has no indices, pass nullptr for indices and 0 for indexCount.
-    void initEBO();
-
     // --------------------------------------------------------
     // Getters
     // --------------------------------------------------------
@@ -63,6 +47,9 @@ public:
     // Size Functions
     vec2 getSize() const;
 
+    // Mesh Functions
+    MeshHandle getMesh() const;
+
     // Velocity Functions
     vec2 getVelocity() const;
 
@@ -107,16 +94,6 @@ public:
     // --------------------------------------------------------
     virtual bool isOverlapping(const vec2& point) const;
 
-    // --------------------------------------------------------
-    // Drawing functions
-    // --------------------------------------------------------
-
-    /// @brief Sets the uniform variables from members, and calls the virtual draw function
-    void setUniforms() const;
-
-    /// @brief Pure virtual function to draw the shape.
-    virtual void draw() const = 0;
-
 protected:
     /// @brief Shader used to draw all abstract shapes.
     Shader & shader;
@@ -131,14 +108,9 @@ protected:
     /// @brief The VAO of the shape
     color color;
 
-    /// @brief The Vertex Array Object, Vertex Buffer Object, and Element Buffer Object of the shape.
-    unsigned int VAO, VBO, EBO;
-
-    /// @brief The vertices of the shape
-    vector<float> vertices;
-
-    /// @brief The indices of the shape
-    vector<unsigned int> indices;
+    /// @brief Handle to the shared mesh this shape is drawn with.
+    /// @details Set by the derived classes' constructor.
+    MeshHandle mesh = INVALID_MESH;
 };
 
 #endif //GRAPHICS_SHAPE_H
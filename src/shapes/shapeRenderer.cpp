@@ -0,0 +1,113 @@
+#include "shapeRenderer.h"
+#include "../renderer/glState.h"
+#include "../util/profiler.h"
+
+#include <cstddef>
+
+ShapeRenderer::ShapeRenderer(Shader& shader) {
+    this->shader = shader;
+    this->initRenderData();
+}
+
+ShapeRenderer::~ShapeRenderer() {
+    for (GLuint VAO : this->VAOs) {
+        if (VAO != 0)
+            GLState::deleteVertexArrays(1, &VAO);
+    }
+    GLState::deleteBuffers(1, &this->instanceVBO);
+}
+
+void ShapeRenderer::initRenderData() {
+    glGenBuffers(1, &this->instanceVBO);
+}
+
+GLuint ShapeRenderer::getVAO(MeshHandle handle) {
+    GLuint& VAO = this->VAOs[handle];
+    if (VAO != 0)
+        return VAO;
+
+    // Combine the shared registry mesh with this renderer's instance buffer
+    const Mesh& mesh = MeshRegistry::getMesh(handle);
+    glGenVertexArrays(1, &VAO);
+    GLState::bindVertexArray(VAO);
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+
+    // Per-instance attributes advance once per instance instead of once per vertex
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+    return VAO;
+}
+
+void ShapeRenderer::setInstanceOffset(size_t first) {
+    // GL 3.3 has no base-instance draws, so point the instance attributes at the run instead
+    size_t base = first * sizeof(Instance);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(base + offsetof(Instance, pos)));
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(base + offsetof(Instance, size)));
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(base + offsetof(Instance, color)));
+}
+
+void ShapeRenderer::submit(const Shape& shape) {
+    submit(shape, shape.getPos());
+}
+
+void ShapeRenderer::submit(const Shape& shape, vec2 pos) {
+    if (shape.getMesh() == INVALID_MESH)
+        return;
+    instances.push_back({pos, shape.getSize(), shape.getColor4()});
+    if (runs.empty() || runs.back().mesh != shape.getMesh())
+        runs.push_back({shape.getMesh(), instances.size() - 1, 0});
+    runs.back().count++;
+}
+
+void ShapeRenderer::submitInstances(MeshHandle mesh, const Instance* data, size_t count) {
+    if (mesh == INVALID_MESH || count == 0)
+        return;
+    instances.insert(instances.end(), data, data + count);
+    if (runs.empty() || runs.back().mesh != mesh)
+        runs.push_back({mesh, instances.size() - count, 0});
+    runs.back().count += count;
+}
+
+void ShapeRenderer::flush() {
+    if (instances.empty())
+        return;
+
+    this->shader.use();
+    GLState::bindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+
+    // Grow the instance buffer geometrically, otherwise orphan it so the driver
+    // does not have to wait on the previous frame's draw before we overwrite it
+    if (instances.size() > instanceCapacity)
+        instanceCapacity = instances.capacity();
+    glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(Instance), instances.data());
+
+    // One instanced draw per run of consecutive shapes sharing a mesh
+    for (const Run& run : runs) {
+        GLState::bindVertexArray(getVAO(run.mesh));
+        GLState::bindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+        setInstanceOffset(run.first);
+        glDrawElementsInstanced(GL_TRIANGLES, MeshRegistry::getMesh(run.mesh).indexCount, GL_UNSIGNED_INT, 0,
+                                static_cast<GLsizei>(run.count));
+        PROFILE_COUNT(DrawCalls, 1);
+        PROFILE_COUNT(Instances, run.count);
+    }
+
+    // Bindings are left in place; GLState skips rebinding them next frame
+    instances.clear();
+    runs.clear();
+}
+
+GLuint ShapeRenderer::getProgram() const {
+    return this->shader.ID;
+}
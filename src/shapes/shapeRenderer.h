@@ -0,0 +1,139 @@
+#ifndef GRAPHICS_SHAPERENDERER_H
+#define GRAPHICS_SHAPERENDERER_H
+
+#include <vector>
+#include "shape.h"
+#include "meshRegistry.h"
+#include "../shader/shader.h"
+
+using std::vector, glm::vec2, glm::vec4;
+
+/**
+ * @brief Batched, instanced renderer for shapes
+ * @details Shapes are submitted during the frame and drawn together with a single
+ * glDrawElementsInstanced call per mesh per flush. Geometry comes from the MeshRegistry;
+ * the position, size and color of each shape are streamed through a per-instance buffer.
+ */
+class ShapeRenderer {
+    public:
+        /**
+         * @brief Per-instance data, laid out to match attributes 1-3 of shape.vert
+         */
+        struct Instance {
+            vec2 pos;
+            vec2 size;
+            vec4 color;
+        };
+
+        /**
+         * @brief Construct a new Shape Renderer object
+         * @details Creates the per-instance buffer
+         *
+         * @param shader The shader to use (expects the instanced shape.vert attributes)
+         */
+        ShapeRenderer(Shader& shader);
+
+        /**
+         * @brief Destroy the Shape Renderer object
+         * @details Deletes the VAO and buffers owned by the renderer
+         */
+        ~ShapeRenderer();
+
+        /**
+         * @brief Queues a shape to be drawn on the next flush
+         * @details Instances are drawn in the order they are submitted
+         *
+         * @param shape The shape to draw
+         */
+        void submit(const Shape& shape);
+
+        /**
+         * @brief Queues a shape to be drawn at a position other than its own
+         * @details Used to draw interpolated positions between simulation ticks
+         *
+         * @param shape The shape to draw
+         * @param pos The center to draw it at
+         */
+        void submit(const Shape& shape, vec2 pos);
+
+        /**
+         * @brief Queues a block of prepared instances that share a mesh
+         * @details Used for entities that are not Shapes (see EntityStore); the instances are
+         * copied, so the caller may reuse its buffer after this returns
+         *
+         * @param mesh The mesh every instance is drawn with
+         * @param data The instances to draw
+         * @param count Number of instances
+         */
+        void submitInstances(MeshHandle mesh, const Instance* data, size_t count);
+
+        /**
+         * @brief Uploads all queued instances and draws them
+         * @details Issues one instanced draw call per run of consecutive shapes sharing a mesh
+         */
+        void flush();
+
+        /**
+         * @brief Returns the shader program shapes are drawn with
+         */
+        GLuint getProgram() const;
+
+    private:
+        /**
+         * @brief The shader to use
+         */
+        Shader shader;
+
+        /**
+         * @brief A run of consecutive instances drawn with the same mesh
+         */
+        struct Run {
+            MeshHandle mesh;
+            size_t first;
+            size_t count;
+        };
+
+        /**
+         * @brief One VAO per mesh type, created on first use (0 until then)
+         */
+        GLuint VAOs[static_cast<unsigned int>(MeshType::Count)] = {};
+
+        /**
+         * @brief The per-instance VBO shared by all meshes
+         */
+        GLuint instanceVBO;
+
+        /**
+         * @brief Number of instances the instance VBO currently has storage for
+         */
+        size_t instanceCapacity = 0;
+
+        /**
+         * @brief Instances queued since the last flush
+         * @details Cleared (but not deallocated) after every flush
+         */
+        vector<Instance> instances;
+
+        /**
+         * @brief Mesh runs queued since the last flush
+         */
+        vector<Run> runs;
+
+        /**
+         * @brief Initializes and configures the buffers and vertex attributes
+         */
+        void initRenderData();
+
+        /**
+         * @brief Returns the VAO combining a registry mesh with the instance buffer
+         * @details Created the first time the mesh is drawn
+         */
+        GLuint getVAO(MeshHandle handle);
+
+        /**
+         * @brief Points the instance attributes of the bound VAO at the given instance
+         */
+        void setInstanceOffset(size_t first);
+};
+
+#endif //GRAPHICS_SHAPERENDERER_H
@@ -0,0 +1,61 @@
+#include "frameStats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+
+namespace {
+    const char *const STAGE_NAMES[FrameStats::StageCount] = {"frame", "input", "update", "collision", "render", "pace", "swap"};
+
+    /// @brief Nearest-rank percentile of sorted samples
+    float percentile(const std::vector<float> &sorted, double fraction) {
+        size_t rank = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+        return sorted[rank];
+    }
+}
+
+void FrameStats::enable(size_t expectedFrames) {
+    enabled = true;
+    for (std::vector<float> &stage : samples)
+        stage.reserve(expectedFrames);
+}
+
+bool FrameStats::isEnabled() const {
+    return enabled;
+}
+
+void FrameStats::record(Stage stage, Clock::duration time) {
+    if (enabled)
+        samples[stage].push_back(std::chrono::duration<float, std::milli>(time).count());
+}
+
+void FrameStats::endFrame() {
+    Clock::time_point now = Clock::now();
+    // the first call only sets the reference point, so startup never counts as a frame
+    if (hasLastFrame)
+        record(Frame, now - lastFrame);
+    lastFrame = now;
+    hasLastFrame = true;
+}
+
+size_t FrameStats::getFrameCount() const {
+    return samples[Frame].size();
+}
+
+double FrameStats::getTotalSeconds() const {
+    return std::accumulate(samples[Frame].begin(), samples[Frame].end(), 0.0) / 1000.0;
+}
+
+void FrameStats::print() const {
+    std::printf("%-10s %8s %9s %9s %9s %9s %9s %9s\n", "stage (ms)", "samples", "mean", "min", "p50", "p95", "p99", "max");
+    for (int stage = 0; stage < StageCount; stage++) {
+        if (samples[stage].empty())
+            continue;
+        std::vector<float> sorted = samples[stage];
+        std::sort(sorted.begin(), sorted.end());
+        double mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+        std::printf("%-10s %8zu %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f\n", STAGE_NAMES[stage], sorted.size(), mean,
+                    sorted.front(), percentile(sorted, 0.5), percentile(sorted, 0.95), percentile(sorted, 0.99),
+                    sorted.back());
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef GRAPHICS_FRAMESTATS_H
+#define GRAPHICS_FRAMESTATS_H
+
+#include <chrono>
+#include <vector>
+
+/**
+ * @brief Keeps every frame's time, and the time of each engine stage, for a summary at exit
+ * @details Unlike the Profiler this is compiled into every build and keeps the whole session
+ * rather than a short history, so stress runs can report exact percentiles. Nothing is recorded
+ * until enable() is called.
+ */
+class FrameStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Stages timed each frame; Frame is the time between consecutive endFrame() calls
+    enum Stage { Frame, Input, Update, Collision, Render, Pace, Swap, StageCount };
+
+    /// @brief Starts recording
+    /// @param expectedFrames Number of frames to reserve storage for
+    void enable(size_t expectedFrames);
+
+    /// @brief Returns true once enable() was called
+    bool isEnabled() const;
+
+    /// @brief Adds a sample to a stage for the current frame
+    void record(Stage stage, Clock::duration time);
+
+    /// @brief Ends a frame and records the time since the previous one
+    void endFrame();
+
+    /// @brief Returns the number of Frame samples recorded
+    size_t getFrameCount() const;
+
+    /// @brief Returns the sum of all Frame samples in seconds
+    double getTotalSeconds() const;
+
+    /// @brief Prints mean, min, p50, p95, p99 and max of every stage in milliseconds
+    void print() const;
+
+    /// @brief Records the enclosing scope as a sample of a stage
+    class Scope {
+    public:
+        Scope(FrameStats &stats, Stage stage) : stats(stats), stage(stage), start(Clock::now()) {}
+        ~Scope() { stats.record(stage, Clock::now() - start); }
+    private:
+        FrameStats &stats;
+        Stage stage;
+        Clock::time_point start;
+    };
+
+private:
+    bool enabled = false;
+
+    /// @brief Samples of each stage in milliseconds, in recording order
+    std::vector<float> samples[StageCount];
+
+    /// @brief End of the previous frame (unset until the first endFrame())
+    Clock::time_point lastFrame;
+    bool hasLastFrame = false;
+};
+
+#endif //GRAPHICS_FRAMESTATS_H
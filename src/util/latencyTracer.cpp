@@ -0,0 +1,118 @@
+#include "latencyTracer.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    const char *const STAGE_NAMES[] = {"input -> tick", "input -> submit", "input -> swap", "input -> gpu done"};
+
+    /// @brief Nearest-rank percentile of sorted samples
+    float percentile(const std::vector<float> &sorted, double fraction) {
+        size_t rank = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+        return sorted[rank];
+    }
+}
+
+void LatencyTracer::enable() {
+    enabled = true;
+    inFlight.reserve(MAX_IN_FLIGHT);
+}
+
+bool LatencyTracer::isEnabled() const {
+    return enabled;
+}
+
+void LatencyTracer::onInput(Clock::time_point eventTime) {
+    if (!enabled)
+        return;
+    if (inFlight.size() >= MAX_IN_FLIGHT) {
+        dropped++;
+        return;
+    }
+    Trace trace = {};
+    trace.input = eventTime;
+    trace.stage = Tick;
+    inFlight.push_back(trace);
+}
+
+void LatencyTracer::advance(Stage stage) {
+    Clock::time_point now = Clock::now();
+    for (Trace &trace : inFlight) {
+        if (trace.stage == stage) {
+            trace.times[stage] = now;
+            trace.stage++;
+        }
+    }
+}
+
+void LatencyTracer::onTick() {
+    if (enabled)
+        advance(Tick);
+}
+
+void LatencyTracer::onSubmit() {
+    if (enabled)
+        advance(Submit);
+}
+
+void LatencyTracer::onSwap() {
+    if (!enabled)
+        return;
+    bool fenced = false;
+    for (Trace &trace : inFlight) {
+        if (trace.stage == Swap) {
+            // each trace owns (and later deletes) its fence
+            trace.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            fenced = true;
+        }
+    }
+    advance(Swap);
+    // submit the fences now, so polling never waits on commands still sitting in the driver
+    if (fenced)
+        glFlush();
+}
+
+void LatencyTracer::poll() {
+    if (!enabled || inFlight.empty())
+        return;
+    Clock::time_point now = Clock::now();
+    for (Trace &trace : inFlight) {
+        if (trace.stage != Gpu)
+            continue;
+        GLenum status = glClientWaitSync(trace.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            continue;
+        trace.times[Gpu] = now;
+        trace.stage = StageCount;
+        glDeleteSync(trace.fence);
+        trace.fence = nullptr;
+        for (int stage = 0; stage < StageCount; stage++)
+            samples[stage].push_back(std::chrono::duration<float, std::milli>(trace.times[stage] - trace.input).count());
+    }
+    inFlight.erase(std::remove_if(inFlight.begin(), inFlight.end(), [](const Trace &trace) {
+        return trace.stage == StageCount;
+    }), inFlight.end());
+}
+
+void LatencyTracer::printReport(const std::string &configuration) const {
+    if (!enabled)
+        return;
+    std::printf("Input latency (%s): %zu traced, %lu dropped\n", configuration.c_str(), samples[Gpu].size(), dropped);
+    if (samples[Gpu].empty())
+        return;
+    std::printf("%-18s %9s %9s %9s\n", "stage (ms)", "p50", "p95", "p99");
+    for (int stage = 0; stage < StageCount; stage++) {
+        std::vector<float> sorted = samples[stage];
+        std::sort(sorted.begin(), sorted.end());
+        std::printf("%-18s %9.3f %9.3f %9.3f\n", STAGE_NAMES[stage], percentile(sorted, 0.5),
+                    percentile(sorted, 0.95), percentile(sorted, 0.99));
+    }
+}
+
+void LatencyTracer::shutdown() {
+    for (Trace &trace : inFlight) {
+        if (trace.fence != nullptr)
+            glDeleteSync(trace.fence);
+    }
+    inFlight.clear();
+}
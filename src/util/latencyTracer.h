@@ -0,0 +1,82 @@
+#ifndef GRAPHICS_LATENCYTRACER_H
+#define GRAPHICS_LATENCYTRACER_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+
+/**
+ * @brief Follows input events through the frame and reports input-to-photon latency
+ * @details A trace starts with the time GLFW delivered a key press and is stamped when the first
+ * simulation tick after it runs, when the frame showing its result is submitted, when that
+ * frame is swapped, and when the GPU has finished the frame. The GPU time comes from a fence
+ * inserted after the swap, which is polled without blocking, so it is an upper bound accurate
+ * to the polling interval (several polls per frame).
+ *
+ * Only the first press of each frame is traced, and at most MAX_IN_FLIGHT traces are open at
+ * once; presses beyond that are counted as dropped. Nothing is recorded until enable().
+ */
+class LatencyTracer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Maximum number of traces waiting for later stages
+    static const int MAX_IN_FLIGHT = 16;
+
+    /// @brief Starts tracing
+    void enable();
+
+    /// @brief Returns true once enable() was called
+    bool isEnabled() const;
+
+    /// @brief Starts a trace for an input event delivered at the given time
+    void onInput(Clock::time_point eventTime);
+
+    /// @brief Stamps traces waiting for a simulation tick
+    void onTick();
+
+    /// @brief Stamps traces waiting for the frame's draw calls to be submitted
+    void onSubmit();
+
+    /// @brief Stamps traces waiting for a swap, and inserts the fence that marks GPU completion
+    void onSwap();
+
+    /// @brief Completes the traces whose fences have signaled
+    void poll();
+
+    /// @brief Prints p50, p95 and p99 from the input event to every stage
+    /// @param configuration Describes the pacing setup the numbers belong to
+    void printReport(const std::string &configuration) const;
+
+    /// @brief Deletes the outstanding fences
+    /// @note Must be called while the OpenGL context is still alive
+    void shutdown();
+
+private:
+    /// @brief Stages a trace passes through, in order
+    enum Stage { Tick, Submit, Swap, Gpu, StageCount };
+
+    struct Trace {
+        Clock::time_point input;
+        Clock::time_point times[StageCount];
+        /// @brief The next stage to stamp
+        int stage;
+        GLsync fence;
+    };
+
+    bool enabled = false;
+
+    /// @brief Open traces, oldest first
+    std::vector<Trace> inFlight;
+
+    /// @brief Latency from the input event to each stage of completed traces, in milliseconds
+    std::vector<float> samples[StageCount];
+
+    unsigned long dropped = 0;
+
+    /// @brief Stamps every open trace waiting for the given stage
+    void advance(Stage stage);
+};
+
+#endif //GRAPHICS_LATENCYTRACER_H
@@ -0,0 +1,157 @@
+#include "profiler.h"
+#include "../renderer/renderQueue.h"
+
+#include <algorithm>
+#include <cstdio>
+
+int Profiler::depth = 0;
+Profiler::Scope Profiler::scopes[Profiler::MAX_SCOPES] = {};
+int Profiler::scopeCount = 0;
+float Profiler::frameHistory[Profiler::HISTORY] = {};
+Profiler::Clock::time_point Profiler::frameStart;
+unsigned long long Profiler::frameNumber = 0;
+unsigned int Profiler::counters[Profiler::CounterCount] = {};
+unsigned int Profiler::lastCounters[Profiler::CounterCount] = {};
+int Profiler::activeGpuScope = -1;
+
+void Profiler::frame() {
+    Clock::time_point now = Clock::now();
+    if (frameNumber > 0) {
+        int slot = static_cast<int>((frameNumber - 1) % HISTORY);
+        frameHistory[slot] = std::chrono::duration<float, std::milli>(now - frameStart).count();
+        for (int i = 0; i < scopeCount; i++) {
+            // GPU times arrive late and are written when read back
+            if (!scopes[i].gpu)
+                scopes[i].history[slot] = static_cast<float>(scopes[i].current);
+            scopes[i].current = 0;
+        }
+        std::copy(counters, counters + CounterCount, lastCounters);
+        std::fill(counters, counters + CounterCount, 0u);
+    }
+    frameStart = now;
+    frameNumber++;
+}
+
+int Profiler::findScope(const char *name, bool gpu) {
+    for (int i = 0; i < scopeCount; i++) {
+        if (scopes[i].name == name)
+            return i;
+    }
+    if (scopeCount == MAX_SCOPES)
+        return -1;
+    Scope &scope = scopes[scopeCount];
+    scope.name = name;
+    scope.gpu = gpu;
+    scope.depth = gpu ? 0 : depth;
+    return scopeCount++;
+}
+
+int Profiler::cpuScope(const char *name) {
+    return findScope(name, false);
+}
+
+void Profiler::addCpuTime(int scope, Clock::duration time) {
+    if (scope >= 0)
+        scopes[scope].current += std::chrono::duration<double, std::milli>(time).count();
+}
+
+void Profiler::beginGpuScope(const char *name) {
+    // GL_TIME_ELAPSED queries cannot overlap, so a nested GPU scope is ignored
+    int index = findScope(name, true);
+    if (index < 0 || activeGpuScope >= 0)
+        return;
+    Scope &scope = scopes[index];
+    int slot = static_cast<int>(frameNumber % QUERY_FRAMES);
+
+    if (scope.queries[0] == 0)
+        glGenQueries(QUERY_FRAMES, scope.queries);
+
+    // collect the result this query produced QUERY_FRAMES frames ago, if the GPU is done with it
+    if (scope.pending[slot]) {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(scope.queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(scope.queries[slot], GL_QUERY_RESULT, &elapsed);
+            int historySlot = static_cast<int>((frameNumber - QUERY_FRAMES - 1) % HISTORY);
+            scope.history[historySlot] = static_cast<float>(elapsed / 1e6);
+        }
+        scope.pending[slot] = false;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, scope.queries[slot]);
+    scope.pending[slot] = true;
+    activeGpuScope = index;
+}
+
+void Profiler::endGpuScope() {
+    if (activeGpuScope < 0)
+        return;
+    glEndQuery(GL_TIME_ELAPSED);
+    activeGpuScope = -1;
+}
+
+void Profiler::count(Counter counter, unsigned int amount) {
+    counters[counter] += amount;
+}
+
+int Profiler::sampleCount() {
+    // the frame in progress has no sample yet
+    return static_cast<int>(std::min<unsigned long long>(frameNumber > 0 ? frameNumber - 1 : 0, HISTORY));
+}
+
+float Profiler::average(const float *history) {
+    int count = sampleCount();
+    if (count == 0)
+        return 0;
+    float sum = 0;
+    for (int i = 0; i < count; i++)
+        sum += history[i];
+    return sum / count;
+}
+
+float Profiler::percentile99(const float *history) {
+    static float scratch[HISTORY];
+    int count = sampleCount();
+    if (count == 0)
+        return 0;
+    std::copy(history, history + count, scratch);
+    int rank = std::min(count - 1, (count * 99) / 100);
+    std::nth_element(scratch, scratch + rank, scratch + count);
+    return scratch[rank];
+}
+
+void Profiler::drawOverlay(RenderQueue &queue, float x, float y) {
+    const float scale = 0.45f;
+    const float lineHeight = 14;
+    const glm::vec3 color = {1, 1, 0};
+    char line[128];
+
+    auto print = [&]() {
+        queue.submitText(line, x, y, scale, color);
+        y -= lineHeight;
+    };
+
+    std::snprintf(line, sizeof(line), "frame  avg %.2f ms  p99 %.2f ms  (%d frames)",
+                  average(frameHistory), percentile99(frameHistory), sampleCount());
+    print();
+    for (int i = 0; i < scopeCount; i++) {
+        const Scope &scope = scopes[i];
+        std::snprintf(line, sizeof(line), "%*s%s %s  avg %.2f ms  p99 %.2f ms", scope.depth * 2, "",
+                      scope.gpu ? "gpu" : "cpu", scope.name, average(scope.history), percentile99(scope.history));
+        print();
+    }
+    std::snprintf(line, sizeof(line), "draw calls %u  instances %u  entities %u",
+                  lastCounters[DrawCalls], lastCounters[Instances], lastCounters[Entities]);
+    print();
+}
+
+void Profiler::shutdown() {
+    if (activeGpuScope >= 0)
+        endGpuScope();
+    for (int i = 0; i < scopeCount; i++) {
+        if (scopes[i].gpu && scopes[i].queries[0] != 0)
+            glDeleteQueries(QUERY_FRAMES, scopes[i].queries);
+    }
+    scopeCount = 0;
+}
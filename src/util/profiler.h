@@ -0,0 +1,148 @@
+#ifndef GRAPHICS_PROFILER_H
+#define GRAPHICS_PROFILER_H
+
+#include <chrono>
+#include <glad/glad.h>
+
+class RenderQueue;
+
+/**
+ * @brief Frame profiler: nestable CPU scopes, GPU timer queries and per-frame counters
+ * @details Every frame is recorded into fixed-size ring buffers, so profiling never allocates
+ * once the scopes have been seen. Use it through the PROFILE_* macros below; they compile to
+ * nothing unless GRAPHICS_PROFILING is defined (CMake defines it for every configuration except
+ * Release).
+ *
+ * GPU scopes use GL_TIME_ELAPSED queries, which cannot overlap, so GPU scopes must not nest.
+ * Results are read QUERY_FRAMES frames later, once they are available, so the CPU never waits
+ * on the GPU.
+ */
+class Profiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief Number of frames kept for averages and percentiles
+    static const int HISTORY = 240;
+
+    /// @brief Maximum number of distinct CPU and GPU scopes
+    static const int MAX_SCOPES = 32;
+
+    /// @brief Frames between issuing a GPU query and reading it back
+    static const int QUERY_FRAMES = 4;
+
+    /// @brief Values counted per frame
+    enum Counter { DrawCalls, Instances, Entities, CounterCount };
+
+    /// @brief Ends the current frame and starts the next one
+    static void frame();
+
+    /// @brief Returns the index of the CPU scope with the given name, registering it on first use
+    /// @param name A string literal (compared by address)
+    static int cpuScope(const char *name);
+
+    /// @brief Adds time spent in a CPU scope this frame
+    static void addCpuTime(int scope, Clock::duration time);
+
+    /// @brief Starts the GPU timer query of a scope
+    static void beginGpuScope(const char *name);
+
+    /// @brief Ends the running GPU timer query
+    static void endGpuScope();
+
+    /// @brief Adds to a counter for the current frame
+    static void count(Counter counter, unsigned int amount);
+
+    /// @brief Queues the overlay text: frame time, scope breakdown and counters
+    /// @param queue The queue to draw the text with
+    /// @param x Left edge of the overlay
+    /// @param y Baseline of the first line
+    static void drawOverlay(RenderQueue &queue, float x, float y);
+
+    /// @brief Deletes the GPU queries
+    /// @note Must be called while the OpenGL context is still alive
+    static void shutdown();
+
+    /// @brief Current nesting depth of CPU scopes (used by ProfileScope)
+    static int depth;
+
+private:
+    /// @brief A named scope and its per-frame times in milliseconds
+    struct Scope {
+        const char *name;
+        bool gpu;
+        int depth;
+        double current;
+        float history[HISTORY];
+        /// @brief GPU only: one query per in-flight frame
+        GLuint queries[QUERY_FRAMES];
+        bool pending[QUERY_FRAMES];
+    };
+
+    static Scope scopes[MAX_SCOPES];
+    static int scopeCount;
+
+    static float frameHistory[HISTORY];
+    static Clock::time_point frameStart;
+    static unsigned long long frameNumber;
+
+    static unsigned int counters[CounterCount];
+    static unsigned int lastCounters[CounterCount];
+
+    /// @brief The GPU scope whose query is running, or -1
+    static int activeGpuScope;
+
+    /// @brief Returns the index of a scope, registering it if needed (-1 if the table is full)
+    static int findScope(const char *name, bool gpu);
+
+    /// @brief Number of valid entries in the history rings
+    static int sampleCount();
+
+    /// @brief Average of the valid entries of a history ring
+    static float average(const float *history);
+
+    /// @brief 99th percentile of the valid entries of a history ring, computed in a static scratch buffer
+    static float percentile99(const float *history);
+};
+
+/// @brief Times the enclosing block as a CPU scope
+class ProfileScope {
+public:
+    explicit ProfileScope(const char *name) : scope(Profiler::cpuScope(name)), start(Profiler::Clock::now()) {
+        Profiler::depth++;
+    }
+    ~ProfileScope() {
+        Profiler::depth--;
+        Profiler::addCpuTime(scope, Profiler::Clock::now() - start);
+    }
+private:
+    int scope;
+    Profiler::Clock::time_point start;
+};
+
+/// @brief Times the enclosing block on the GPU
+class GpuProfileScope {
+public:
+    explicit GpuProfileScope(const char *name) { Profiler::beginGpuScope(name); }
+    ~GpuProfileScope() { Profiler::endGpuScope(); }
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#ifdef GRAPHICS_PROFILING
+/// @brief Marks the boundary between two frames
+#define PROFILE_FRAME() Profiler::frame()
+/// @brief Times the rest of the enclosing block as a named CPU scope
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+/// @brief Times the rest of the enclosing block on the GPU (must not nest)
+#define PROFILE_GPU_SCOPE(name) GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(name)
+/// @brief Adds to a per-frame counter (Profiler::Counter)
+#define PROFILE_COUNT(counter, amount) Profiler::count(Profiler::counter, static_cast<unsigned int>(amount))
+#else
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_GPU_SCOPE(name) ((void)0)
+#define PROFILE_COUNT(counter, amount) ((void)0)
+#endif
+
+#endif //GRAPHICS_PROFILER_H
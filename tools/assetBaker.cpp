@@ -0,0 +1,107 @@
+// Offline asset baker: packs shader sources and a pre-rasterized glyph atlas into one binary
+// bundle that the engine memory maps at startup (see src/assets/assetBundle.h).
+//
+// Usage: assetBaker <output> <font.ttf> <fontSize> <bitmap|sdf> [<name> <file>]...
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/assets/assetBundle.h"
+#include "../src/font/glyphAtlas.h"
+
+namespace {
+    /// @brief An asset waiting to be written
+    struct PendingAsset {
+        std::string name;
+        std::string bytes;
+    };
+
+    /// @brief Every entry starts on a 16 byte boundary so baked structs can be used in place
+    const size_t ALIGNMENT = 16;
+
+    size_t align(size_t offset) {
+        return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    template<typename T>
+    void append(std::string &bytes, const T &value) {
+        bytes.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 5 || (argc - 5) % 2 != 0) {
+        std::cout << "Usage: assetBaker <output> <font.ttf> <fontSize> <bitmap|sdf> [<name> <file>]..." << std::endl;
+        return 1;
+    }
+
+    std::vector<PendingAsset> assets;
+
+    // Text files are stored with a terminating NUL so they can be passed straight to GL
+    for (int i = 5; i < argc; i += 2) {
+        std::ifstream file(argv[i + 1], std::ios::binary);
+        if (!file) {
+            std::cout << "ERROR::BAKER: Failed to read " << argv[i + 1] << std::endl;
+            return 1;
+        }
+        std::stringstream stream;
+        stream << file.rdbuf();
+        std::string bytes = stream.str();
+        bytes.push_back('\0');
+        if (std::strlen(argv[i]) >= sizeof(AssetBundleEntry::name)) {
+            std::cout << "ERROR::BAKER: Asset name too long: " << argv[i] << std::endl;
+            return 1;
+        }
+        assets.push_back({argv[i], bytes});
+    }
+
+    // Rasterize the font once, here, instead of on every launch
+    FontMode mode = std::strcmp(argv[4], "sdf") == 0 ? FontMode::SDF : FontMode::Bitmap;
+    GlyphAtlas atlas;
+    if (!rasterizeGlyphAtlas(argv[2], static_cast<unsigned int>(std::stoul(argv[3])), mode, atlas))
+        return 1;
+    std::string fontBytes;
+    BakedFontHeader fontHeader = {static_cast<uint32_t>(atlas.mode), static_cast<uint32_t>(atlas.width),
+                                  static_cast<uint32_t>(atlas.height), GLYPH_COUNT};
+    append(fontBytes, fontHeader);
+    append(fontBytes, atlas.glyphs);
+    fontBytes.append(reinterpret_cast<const char *>(atlas.pixels.data()), atlas.pixels.size());
+    assets.push_back({ASSET_FONT_ATLAS, fontBytes});
+
+    // Lay out header, table of contents and aligned data
+    AssetBundleHeader header = {ASSET_BUNDLE_MAGIC, ASSET_BUNDLE_VERSION, static_cast<uint32_t>(assets.size()),
+                                static_cast<uint32_t>(sizeof(Character))};
+    std::vector<AssetBundleEntry> entries(assets.size());
+    size_t offset = align(sizeof(AssetBundleHeader) + assets.size() * sizeof(AssetBundleEntry));
+    for (size_t i = 0; i < assets.size(); i++) {
+        std::memset(entries[i].name, 0, sizeof(entries[i].name));
+        std::strncpy(entries[i].name, assets[i].name.c_str(), sizeof(entries[i].name) - 1);
+        entries[i].offset = offset;
+        entries[i].size = assets[i].bytes.size();
+        offset = align(offset + assets[i].bytes.size());
+    }
+
+    std::string bundle;
+    bundle.reserve(offset);
+    append(bundle, header);
+    for (const AssetBundleEntry &entry : entries)
+        append(bundle, entry);
+    for (size_t i = 0; i < assets.size(); i++) {
+        bundle.resize(entries[i].offset, '\0');
+        bundle += assets[i].bytes;
+    }
+    bundle.resize(offset, '\0');
+
+    std::ofstream output(argv[1], std::ios::binary | std::ios::trunc);
+    output.write(bundle.data(), static_cast<std::streamsize>(bundle.size()));
+    if (!output) {
+        std::cout << "ERROR::BAKER: Failed to write " << argv[1] << std::endl;
+        return 1;
+    }
+    std::cout << "Baked " << assets.size() << " assets (" << bundle.size() << " bytes) into " << argv[1] << std::endl;
+    return 0;
+}